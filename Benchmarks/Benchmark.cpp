@@ -0,0 +1,79 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+const void* volatile benchmarkSink = nullptr;
+
+void Benchmark::Add(const std::string& name, std::function<void()> function, size_t bytes)
+{
+	cases.push_back({ name, std::move(function), bytes, 0 });
+}
+
+void Benchmark::AddOperations(const std::string& name, std::function<void()> function, size_t operations)
+{
+	cases.push_back({ name, std::move(function), 0, operations });
+}
+
+bool Benchmark::Matches(const std::string& name, const std::string& filter)
+{
+	return name.find(filter) != std::string::npos;
+}
+
+static void formatTime(char* buffer, size_t size, double seconds)
+{
+	if (seconds >= 1e-3)
+		snprintf(buffer, size, "%.3f ms", seconds * 1e3);
+	else if (seconds >= 1e-6)
+		snprintf(buffer, size, "%.3f us", seconds * 1e6);
+	else
+		snprintf(buffer, size, "%.1f ns", seconds * 1e9);
+}
+
+void Benchmark::Run(const std::string& filter) const
+{
+	using clock = std::chrono::steady_clock;
+
+	printf("%-48s %14s %12s %10s %12s %12s\n", "benchmark", "time/iter", "iterations", "MB/s", "time/op", "ops/s");
+	for (const Case& c : cases) {
+		if (!Matches(c.name, filter))
+			continue;
+
+		// warm up caches and find an iteration count long enough to time
+		size_t iterations = 1;
+		while (true) {
+			auto start = clock::now();
+			for (size_t i = 0; i < iterations; i++)
+				c.function();
+			double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+			if (elapsed >= minSampleTime)
+				break;
+			iterations *= elapsed > 0.0 ? std::clamp<size_t>((size_t)(minSampleTime / elapsed * 1.2), 2, 100) : 100;
+		}
+
+		double best = 1e300;
+		for (int s = 0; s < sampleCount; s++) {
+			auto start = clock::now();
+			for (size_t i = 0; i < iterations; i++)
+				c.function();
+			best = std::min(best, std::chrono::duration<double>(clock::now() - start).count() / iterations);
+		}
+
+		char time[32];
+		formatTime(time, sizeof(time), best);
+
+		char throughput[32] = "-";
+		if (c.bytes > 0)
+			snprintf(throughput, sizeof(throughput), "%.1f", c.bytes / best / 1e6);
+
+		char operationTime[32] = "-";
+		char operationRate[32] = "-";
+		if (c.operations > 0) {
+			formatTime(operationTime, sizeof(operationTime), best / c.operations);
+			snprintf(operationRate, sizeof(operationRate), "%.3g", c.operations / best);
+		}
+
+		printf("%-48s %14s %12zu %10s %12s %12s\n", c.name.c_str(), time, iterations, throughput, operationTime,
+			operationRate);
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <string>
+#include <vector>
+
+// Minimal timing harness. Every case is repeated until one sample takes at least minSampleTime,
+// the fastest of sampleCount samples is reported as time per iteration (and throughput when bytes or operations is set).
+class Benchmark
+{
+private:
+	struct Case {
+		std::string name;
+		std::function<void()> function;
+		size_t bytes;
+		size_t operations;
+	};
+
+	std::vector<Case> cases;
+
+public:
+	double minSampleTime = 0.2; // in seconds
+	int sampleCount = 5;
+
+	// bytes is the input size processed by one call of function
+	void Add(const std::string& name, std::function<void()> function, size_t bytes = 0);
+
+	// for functions that loop over a batch of inputs, operations is the batch size and the time per operation is reported
+	void AddOperations(const std::string& name, std::function<void()> function, size_t operations);
+
+	// runs the cases whose name contains filter
+	void Run(const std::string& filter = "") const;
+
+	// whether Run(filter) would run a case called name
+	static bool Matches(const std::string& name, const std::string& filter);
+};
+
+extern const void* volatile benchmarkSink;
+
+// keeps the optimizer from discarding a result that is never read, the barrier forces value to be in memory
+template <typename T>
+void doNotOptimize(const T& value)
+{
+	benchmarkSink = &value;
+#if defined(_MSC_VER)
+	_ReadWriteBarrier();
+#else
+	asm volatile("" : : "r"(&value) : "memory");
+#endif
+}
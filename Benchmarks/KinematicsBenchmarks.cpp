@@ -0,0 +1,160 @@
+#define _USE_MATH_DEFINES
+#include "KinematicsBenchmarks.h"
+#include "kinematicsBatch.h"
+#include "simulator.h"
+#include <cmath>
+#include <memory>
+#include <random>
+
+// inputs per call, large enough to hide the call overhead and small enough to stay in L1/L2
+const size_t poseCount = 1024;
+const glm::vec3 benchmarkLengths = glm::vec3(3.f, 2.f, 4.f);
+
+struct PoseSet {
+	std::vector<ConfigurationSpace> configSpaces;
+	std::vector<Transform> effectors;
+	// effector poses within 1e-3 of a singularity, where calculateJoints takes its fallback branches
+	std::vector<Transform> nearSingular;
+	std::vector<Frame> frames;
+	std::vector<float> angles;
+	FrameBatch effectorBatch;
+	FrameBatch nearSingularBatch;
+	ConfigurationSpaceBatch configSpaceBatch;
+};
+
+// Effector pose whose X axis is direction, rolled by a random angle around it
+static Transform effectorWithX(std::mt19937& random, const glm::vec3& p4, const glm::vec3& direction)
+{
+	std::uniform_real_distribution<float> roll((float)-M_PI, (float)M_PI);
+	glm::vec3 x = glm::normalize(direction);
+	glm::quat rotation = glm::angleAxis(roll(random), x) * glm::rotation(unitX, x);
+	return Transform(p4 + x * benchmarkLengths.z, rotation);
+}
+
+// Fixed seed, so every run and every commit measures the same inputs
+static std::unique_ptr<PoseSet> generatePoses()
+{
+	std::mt19937 random(12345);
+	std::uniform_real_distribution<float> angle((float)-M_PI, (float)M_PI);
+	std::uniform_real_distribution<float> extension(0.5f, 6.f);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+	// log-uniform, so both sides of singularityEpsilon are covered
+	std::uniform_real_distribution<float> offsetExponent(-7.f, -3.f);
+	auto offset = [&]() { return std::pow(10.f, offsetExponent(random)); };
+
+	auto poses = std::make_unique<PoseSet>();
+	for (size_t i = 0; i < poseCount; i++) {
+		// configurations mapped through the forward kinematics are reachable by construction
+		ConfigurationSpace configSpace(angle(random), angle(random), extension(random), angle(random), angle(random),
+			angle(random));
+		Transform effector = calculateFramesFromConfSpace(configSpace, benchmarkLengths)[4];
+		poses->configSpaces.push_back(configSpace);
+		poses->effectors.push_back(effector);
+		poses->frames.push_back(Frame(effector.GetOrigin(), effector.GetRotation()));
+		poses->angles.push_back(angle(random) * 4.f);
+
+		glm::vec3 p4 = effector.GetOrigin() - effector.GetX() * benchmarkLengths.z;
+		if (i % 2 == 0) {
+			// wrist centre next to the base axis
+			float phi = angle(random);
+			float distance = offset();
+			p4 = glm::vec3(distance * std::cos(phi), distance * std::sin(phi), p4.z);
+			poses->nearSingular.push_back(effectorWithX(random, p4, effector.GetX()));
+		}
+		else {
+			// effector X axis almost parallel to the arm plane normal, so the forearm direction degenerates
+			glm::vec3 norm = glm::normalize(glm::cross(glm::normalize(p4), unitZ));
+			glm::vec3 noise = glm::vec3(unit(random), unit(random), unit(random)) * offset();
+			poses->nearSingular.push_back(effectorWithX(random, p4, norm + noise));
+		}
+	}
+
+	poses->effectorBatch.Reserve(poseCount);
+	poses->nearSingularBatch.Reserve(poseCount);
+	poses->configSpaceBatch.Reserve(poseCount);
+	for (size_t i = 0; i < poseCount; i++) {
+		poses->effectorBatch.Push(poses->effectors[i]);
+		poses->nearSingularBatch.Push(poses->nearSingular[i]);
+		poses->configSpaceBatch.Push(poses->configSpaces[i]);
+	}
+	return poses;
+}
+
+static void addIKCases(Benchmark& benchmark, const std::shared_ptr<PoseSet>& poses, bool nearSingular)
+{
+	const std::string name = nearSingular ? "near singular" : "reachable";
+	const std::vector<Transform>& effectors = nearSingular ? poses->nearSingular : poses->effectors;
+	const FrameBatch& effectorBatch = nearSingular ? poses->nearSingularBatch : poses->effectorBatch;
+
+	// the lambdas keep poses alive, so the references stay valid
+	benchmark.AddOperations("solveInverseKinematics/" + name, [poses, &effectors]() {
+		for (const Transform& effector : effectors)
+			doNotOptimize(solveInverseKinematics(effector, benchmarkLengths, nullptr));
+	}, poseCount);
+
+	benchmark.AddOperations("calculateJoints/" + name, [poses, &effectors]() {
+		for (const Transform& effector : effectors)
+			doNotOptimize(calculateJoints(effector, benchmarkLengths, nullptr));
+	}, poseCount);
+
+	auto result = std::make_shared<IKBatchResult>();
+	benchmark.AddOperations("solveInverseKinematicsBatch/" + name, [poses, &effectorBatch, result]() {
+		solveInverseKinematicsBatch(effectorBatch, benchmarkLengths, *result);
+		doNotOptimize(*result);
+	}, poseCount);
+}
+
+void registerKinematicsBenchmarks(Benchmark& benchmark)
+{
+	// shared by the lambdas, which outlive this function
+	std::shared_ptr<PoseSet> poses = generatePoses();
+
+	benchmark.AddOperations("normalizeAngle", [poses]() {
+		for (float angle : poses->angles)
+			doNotOptimize(normalizeAngle(angle));
+	}, poseCount);
+
+	benchmark.AddOperations("Frame::GetMatrix", [poses]() {
+		for (const Frame& frame : poses->frames)
+			doNotOptimize(frame.GetMatrix());
+	}, poseCount);
+
+	benchmark.AddOperations("Transform::GetMatrix", [poses]() {
+		for (const Transform& effector : poses->effectors)
+			doNotOptimize(effector.GetMatrix());
+	}, poseCount);
+
+	benchmark.AddOperations("interpolateFrames", [poses]() {
+		for (size_t i = 0; i + 1 < poseCount; i++)
+			doNotOptimize(interpolateFrames(poses->effectors[i], poses->effectors[i + 1], 0.37f));
+	}, poseCount - 1);
+
+	benchmark.AddOperations("calculateFramesFromConfSpace", [poses]() {
+		for (const ConfigurationSpace& configSpace : poses->configSpaces)
+			doNotOptimize(calculateFramesFromConfSpace(configSpace, benchmarkLengths));
+	}, poseCount);
+
+	auto links = std::make_shared<std::vector<glm::mat4>>();
+	benchmark.AddOperations("calculateFramesFromConfSpaceBatch", [poses, links]() {
+		calculateFramesFromConfSpaceBatch(poses->configSpaceBatch, benchmarkLengths, *links);
+		doNotOptimize(*links);
+	}, poseCount);
+
+	addIKCases(benchmark, poses, false);
+	addIKCases(benchmark, poses, true);
+	benchmark.AddOperations("tick", [poses]() {
+		// the work SimulationWorker::Publish does per tick, along one trajectory of poseCount ticks
+		SymParams params(poses->effectors[0], poses->effectors[1], 100.f, benchmarkLengths);
+		SymPlan plan = planTrajectory(params);
+		glm::vec3 prevP3 = plan.startP3;
+		SymData data;
+		for (size_t i = 0; i < poseCount; i++) {
+			float t = (float)i / (poseCount - 1);
+			Transform effectorFrame = interpolateFrames(params.startFrame, params.endFrame, t);
+			Joints joints = calculateJoints(effectorFrame, params.lengths, &prevP3);
+			prevP3 = joints.p3;
+			calculateSymData(params, plan, t, effectorFrame, joints, data);
+			doNotOptimize(data);
+		}
+	}, poseCount);
+}
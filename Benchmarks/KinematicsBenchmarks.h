@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Benchmark.h"
+
+// IK/FK and interpolation cases over fixed sets of random reachable and near singular poses
+void registerKinematicsBenchmarks(Benchmark& benchmark);
@@ -0,0 +1,117 @@
+#include "ParserBenchmarks.h"
+#include "LegacyParser.h"
+#include "Parser.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <streambuf>
+
+namespace fs = std::filesystem;
+
+// Writes a UV sphere with rings * segments quads split into triangles, in the "f a//b" form the bundled meshes use
+static void writeSyntheticObj(std::ostream& file, int rings, int segments)
+{
+	file.precision(6);
+	file << std::fixed;
+
+	const float pi = 3.14159265f;
+	for (int r = 0; r <= rings; r++) {
+		float theta = pi * r / rings;
+		for (int s = 0; s <= segments; s++) {
+			float phi = 2.f * pi * s / segments;
+			glm::vec3 n(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+			file << "v " << n.x << ' ' << n.y << ' ' << n.z << '\n';
+			file << "vn " << n.x << ' ' << n.y << ' ' << n.z << '\n';
+		}
+	}
+
+	for (int r = 0; r < rings; r++) {
+		for (int s = 0; s < segments; s++) {
+			int a = r * (segments + 1) + s + 1;
+			int b = a + segments + 1;
+			file << "f " << a << "//" << a << ' ' << b << "//" << b << ' ' << a + 1 << "//" << a + 1 << '\n';
+			file << "f " << a + 1 << "//" << a + 1 << ' ' << b << "//" << b << ' ' << b + 1 << "//" << b + 1 << '\n';
+		}
+	}
+}
+
+// discards what is written and counts the bytes
+class CountingBuffer : public std::streambuf
+{
+public:
+	size_t count = 0;
+
+protected:
+	int_type overflow(int_type c) override
+	{
+		count++;
+		return traits_type::not_eof(c);
+	}
+
+	std::streamsize xsputn(const char*, std::streamsize n) override
+	{
+		count += (size_t)n;
+		return n;
+	}
+};
+
+// Returns the path of the synthetic mesh, writing it when it is missing or does not have the expected size.
+// It is written aside and renamed, so an interrupted run never leaves a truncated file to be reused.
+static std::string prepareSyntheticObj(int rings, int segments)
+{
+	std::string path = (fs::temp_directory_path() / "puma_synthetic.obj").string();
+
+	CountingBuffer counter;
+	std::ostream counted(&counter);
+	writeSyntheticObj(counted, rings, segments);
+
+	std::error_code error;
+	if (fs::exists(path) && fs::file_size(path, error) == counter.count)
+		return path;
+
+	std::cout << "Writing " << path << std::endl;
+	const std::string tempPath = path + ".tmp";
+	bool written;
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		writeSyntheticObj(file, rings, segments);
+		written = file.good();
+	}
+	if (written)
+		fs::rename(tempPath, path, error);
+	if (!written || error) {
+		fs::remove(tempPath, error);
+		throw std::runtime_error("Failed to write " + path);
+	}
+	return path;
+}
+
+static void addParserCases(Benchmark& benchmark, const std::string& name, const std::string& path, bool optimize)
+{
+	size_t bytes = (size_t)fs::file_size(path);
+	benchmark.Add("LegacyParser::ReadObj/" + name, [path]() { doNotOptimize(LegacyParser::ReadObj(path)); }, bytes);
+	benchmark.Add("Parser::ReadObj/1 thread/" + name, [path]() { doNotOptimize(Parser::ReadObj(path, 1)); }, bytes);
+	benchmark.Add("Parser::ReadObj/" + name, [path]() { doNotOptimize(Parser::ReadObj(path)); }, bytes);
+	if (optimize)
+		benchmark.Add("Parser::ParseObj/" + name, [path]() { doNotOptimize(Parser::ParseObj(path)); }, bytes);
+}
+
+void registerParserBenchmarks(Benchmark& benchmark, const std::string& meshDirectory, const std::string& filter)
+{
+	for (const char* mesh : { "cylinder.obj", "sphere.obj", "pointerX.obj" }) {
+		fs::path path = fs::path(meshDirectory) / mesh;
+		if (fs::exists(path))
+			addParserCases(benchmark, mesh, path.string(), true);
+	}
+
+	// ~1M triangles, about the size of a detailed CAD export, registered and written only when the filter selects one of its cases
+	const std::string synthetic = "synthetic.obj";
+	for (const char* prefix : { "LegacyParser::ReadObj/", "Parser::ReadObj/1 thread/", "Parser::ReadObj/" }) {
+		if (Benchmark::Matches(prefix + synthetic, filter)) {
+			addParserCases(benchmark, synthetic, prepareSyntheticObj(500, 1000), false);
+			break;
+		}
+	}
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "Benchmark.h"
+#include <string>
+
+// OBJ loading cases: the bundled meshes found in meshDirectory and a generated large sphere, the latter only when
+// filter selects any of its cases
+void registerParserBenchmarks(Benchmark& benchmark, const std::string& meshDirectory, const std::string& filter = "");
@@ -0,0 +1,24 @@
+#include "Benchmark.h"
+#include "KinematicsBenchmarks.h"
+#include "ParserBenchmarks.h"
+#include <iostream>
+
+// usage: Benchmarks [mesh directory] [filter]
+int main(int argc, char** argv)
+{
+	std::string meshDirectory = argc > 1 ? argv[1] : "Meshes";
+	std::string filter = argc > 2 ? argv[2] : "";
+
+	Benchmark benchmark;
+	try {
+		registerKinematicsBenchmarks(benchmark);
+		registerParserBenchmarks(benchmark, meshDirectory, filter);
+		benchmark.Run(filter);
+	}
+	catch (const std::exception& e) {
+		std::cout << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// std140 mirror of the FrameUniforms block at binding 0, declared once in Shaders/frameUniforms.glsl
+struct FrameUniforms {
+	glm::mat4 view;
+	glm::mat4 proj;
+	// view of the Z-up robot models, see modelToScene in main.cpp
+	glm::mat4 phongView;
+	// positions in the Z-up model space, w unused
+	glm::vec4 viewPos;
+	glm::vec4 lightPos;
+	glm::vec4 lightColor;
+	float ambientStrength;
+	float specularStrength;
+	float shininess;
+	float padding;
+};
+
+const unsigned int frameUniformsBinding = 0;
@@ -0,0 +1,116 @@
+#include "GeometryArena.h"
+#include <algorithm>
+
+// Reallocates buffer to capacity bytes keeping the first used bytes. The contents go through a temporary
+// buffer on the GPU, so the buffer name and with it the VAO bindings stay valid.
+static void growBuffer(GLuint buffer, GLsizeiptr used, GLsizeiptr capacity)
+{
+	GLuint temp = 0;
+	if (used > 0) {
+		glGenBuffers(1, &temp);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, temp);
+		glBufferData(GL_COPY_WRITE_BUFFER, used, nullptr, GL_STREAM_COPY);
+		glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, used);
+	}
+
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	glBufferData(GL_COPY_WRITE_BUFFER, capacity, nullptr, GL_STATIC_DRAW);
+
+	if (used > 0) {
+		glBindBuffer(GL_COPY_READ_BUFFER, temp);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, used);
+		glDeleteBuffers(1, &temp);
+	}
+
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+static void appendBuffer(GLuint buffer, GLintptr offset, const void* data, GLsizeiptr size)
+{
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+GeometryArena::GeometryArena() : indirectCapacity(0), vertexCount(0), indexCount(0), vertexCapacity(0), indexCapacity(0)
+{
+	vao.Bind();
+	vbo = VBO((VertexStruct*)nullptr, 0);
+	ebo = EBO(nullptr, 0);
+
+	vao.LinkAttrib(vbo, 0, 3, GL_FLOAT, sizeof(VertexStruct), (void*)0);
+	vao.LinkAttrib(vbo, 1, 3, GL_FLOAT, sizeof(VertexStruct), (void*)offsetof(VertexStruct, normal));
+	vao.Unbind();
+	vbo.Unbind();
+	ebo.Unbind();
+
+	glGenBuffers(1, &indirectBuffer);
+}
+
+int GeometryArena::Add(const MeshData& mesh)
+{
+	// indices stay local to the mesh, baseVertex offsets them at draw time
+	MeshRange range;
+	range.firstIndex = (GLuint)indexCount;
+	range.indexCount = (GLuint)mesh.GetIndexCount();
+	range.baseVertex = (GLint)vertexCount;
+	meshes.push_back(range);
+
+	// capacity doubles, so loading n meshes copies the arena O(log n) times
+	if (vertexCount + mesh.GetVertexCount() > vertexCapacity) {
+		vertexCapacity = std::max(vertexCapacity * 2, vertexCount + mesh.GetVertexCount());
+		growBuffer(vbo.ID, vertexCount * sizeof(VertexStruct), vertexCapacity * sizeof(VertexStruct));
+	}
+	if (indexCount + mesh.GetIndexCount() > indexCapacity) {
+		indexCapacity = std::max(indexCapacity * 2, indexCount + mesh.GetIndexCount());
+		growBuffer(ebo.ID, indexCount * sizeof(GLuint), indexCapacity * sizeof(GLuint));
+	}
+
+	appendBuffer(vbo.ID, vertexCount * sizeof(VertexStruct), mesh.GetVertices(), mesh.GetVertexCount() * sizeof(VertexStruct));
+	appendBuffer(ebo.ID, indexCount * sizeof(GLuint), mesh.GetIndices(), mesh.GetIndexCount() * sizeof(GLuint));
+	vertexCount += mesh.GetVertexCount();
+	indexCount += mesh.GetIndexCount();
+
+	return (int)meshes.size() - 1;
+}
+
+const MeshRange& GeometryArena::GetMesh(int id) const
+{
+	return meshes[id];
+}
+
+DrawElementsIndirectCommand GeometryArena::GetCommand(int id, GLuint instanceCount, GLuint baseInstance) const
+{
+	const MeshRange& range = meshes[id];
+	return { range.indexCount, instanceCount, range.firstIndex, range.baseVertex, baseInstance };
+}
+
+void GeometryArena::Draw(const std::vector<DrawElementsIndirectCommand>& commands)
+{
+	if (commands.empty())
+		return;
+
+	GLsizeiptr size = commands.size() * sizeof(DrawElementsIndirectCommand);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+	if (size > indirectCapacity)
+		indirectCapacity = size;
+	// orphan, the previous commands may still be read by the GPU
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, indirectCapacity, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, size, commands.data());
+
+	vao.Bind();
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, (GLsizei)commands.size(), 0);
+	vao.Unbind();
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void GeometryArena::Delete()
+{
+	vao.Delete();
+	vbo.Delete();
+	ebo.Delete();
+	glDeleteBuffers(1, &indirectBuffer);
+}
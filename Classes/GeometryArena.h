@@ -0,0 +1,58 @@
+#pragma once
+
+#include "VAO.h"
+#include "VBO.h"
+#include "EBO.h"
+#include "MeshData.h"
+#include "VertexStruct.h"
+#include <vector>
+
+// Location of one mesh inside the arena
+struct MeshRange {
+	GLuint firstIndex;
+	GLuint indexCount;
+	GLint baseVertex;
+};
+
+// Layout mandated by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;
+};
+
+// Every static triangle mesh packed into one vertex buffer and one index buffer behind a single VAO,
+// so any set of meshes is drawn with one glMultiDrawElementsIndirect call.
+class GeometryArena
+{
+private:
+	VAO vao;
+	VBO vbo;
+	EBO ebo;
+	GLuint indirectBuffer;
+	GLsizeiptr indirectCapacity;
+
+	// in elements
+	size_t vertexCount;
+	size_t indexCount;
+	size_t vertexCapacity;
+	size_t indexCapacity;
+	std::vector<MeshRange> meshes;
+
+public:
+	GeometryArena();
+
+	// appends the mesh blocks to the arena buffers and returns the id of the mesh
+	int Add(const MeshData& mesh);
+	const MeshRange& GetMesh(int id) const;
+	DrawElementsIndirectCommand GetCommand(int id, GLuint instanceCount, GLuint baseInstance) const;
+
+	size_t GetVertexCount() const { return vertexCount; }
+	size_t GetIndexCount() const { return indexCount; }
+
+	// uploads the commands and submits them as a single multi-draw
+	void Draw(const std::vector<DrawElementsIndirectCommand>& commands);
+	void Delete();
+};
@@ -0,0 +1,97 @@
+#include "Histogram.h"
+#include <algorithm>
+#include <cmath>
+
+static int floorLog2(uint64_t value)
+{
+	int log = 0;
+	while (value >>= 1)
+		log++;
+	return log;
+}
+
+Histogram::Histogram()
+{
+	Reset();
+}
+
+int Histogram::BucketIndex(uint64_t value)
+{
+	// the first two sub-bucket ranges are exact
+	if (value < 2 * subBucketCount)
+		return (int)value;
+
+	// values of 2^maxValueBits and above saturate into the top bucket
+	int shift = std::min(floorLog2(value), maxValueBits - 1) - subBucketBits;
+	uint64_t subBucket = std::min<uint64_t>(value >> shift, 2 * subBucketCount - 1);
+	return shift * subBucketCount + (int)subBucket;
+}
+
+uint64_t Histogram::BucketLow(int index)
+{
+	if (index < 2 * subBucketCount)
+		return index;
+
+	int shift = index / subBucketCount - 1;
+	uint64_t subBucket = index % subBucketCount + subBucketCount;
+	return subBucket << shift;
+}
+
+uint64_t Histogram::BucketHigh(int index)
+{
+	if (index < 2 * subBucketCount)
+		return index;
+
+	int shift = index / subBucketCount - 1;
+	return BucketLow(index) + (uint64_t(1) << shift) - 1;
+}
+
+void Histogram::Record(uint64_t value)
+{
+	counts[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	totalCount.fetch_add(1, std::memory_order_relaxed);
+	sum.fetch_add(value, std::memory_order_relaxed);
+	if (value > max.load(std::memory_order_relaxed))
+		max.store(value, std::memory_order_relaxed);
+}
+
+void Histogram::Reset()
+{
+	for (auto& count : counts)
+		count.store(0, std::memory_order_relaxed);
+	totalCount.store(0, std::memory_order_relaxed);
+	sum.store(0, std::memory_order_relaxed);
+	max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Histogram::GetTotalCount() const
+{
+	return totalCount.load(std::memory_order_relaxed);
+}
+
+uint64_t Histogram::GetMax() const
+{
+	return max.load(std::memory_order_relaxed);
+}
+
+double Histogram::GetMean() const
+{
+	uint64_t count = GetTotalCount();
+	return count == 0 ? 0.0 : (double)sum.load(std::memory_order_relaxed) / count;
+}
+
+uint64_t Histogram::GetValueAtPercentile(double percentile) const
+{
+	uint64_t count = GetTotalCount();
+	if (count == 0)
+		return 0;
+
+	uint64_t target = std::max<uint64_t>(1, (uint64_t)std::ceil(count * std::clamp(percentile, 0.0, 100.0) / 100.0));
+	uint64_t seen = 0;
+	for (int i = 0; i < bucketCount; i++) {
+		seen += counts[i].load(std::memory_order_relaxed);
+		if (seen >= target)
+			return std::min(BucketHigh(i), GetMax());
+	}
+	return GetMax();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Log-linear histogram in the spirit of HdrHistogram. Values are grouped by their power of two and every power
+// of two is split into subBucketCount linear sub-buckets, so any recorded value is known to within ~3% from 1 up
+// to 2^40 with a fixed, small table. One thread records, any thread may read.
+class Histogram
+{
+private:
+	static constexpr int subBucketBits = 5;
+	static constexpr int subBucketCount = 1 << subBucketBits;
+	static constexpr int maxValueBits = 40;
+	static constexpr int bucketCount = (maxValueBits - subBucketBits + 1) * subBucketCount;
+
+	std::array<std::atomic<uint64_t>, bucketCount> counts;
+	std::atomic<uint64_t> totalCount;
+	std::atomic<uint64_t> sum;
+	std::atomic<uint64_t> max;
+
+	static int BucketIndex(uint64_t value);
+	// smallest and largest value that falls into the bucket
+	static uint64_t BucketLow(int index);
+	static uint64_t BucketHigh(int index);
+
+public:
+	Histogram();
+
+	void Record(uint64_t value);
+	void Reset();
+
+	uint64_t GetTotalCount() const;
+	uint64_t GetMax() const;
+	double GetMean() const;
+	// upper bound of the bucket holding the given percentile (0 - 100)
+	uint64_t GetValueAtPercentile(double percentile) const;
+
+	int GetBucketCount() const { return bucketCount; }
+	uint64_t GetBucketCountAt(int index) const { return counts[index].load(std::memory_order_relaxed); }
+	uint64_t GetBucketLow(int index) const { return BucketLow(index); }
+	uint64_t GetBucketHigh(int index) const { return BucketHigh(index); }
+};
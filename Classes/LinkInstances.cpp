@@ -0,0 +1,73 @@
+#include "LinkInstances.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+LinkInstance::LinkInstance(const glm::mat4& model, const glm::vec4& color) :
+	model(model), normalMatrix(glm::transpose(glm::inverse(glm::mat3(model)))), color(color) {}
+
+LinkInstances::LinkInstances(const std::array<glm::vec4, linkMeshCount>& colors) : colors(colors) {}
+
+void LinkInstances::Clear()
+{
+	for (auto& meshInstances : instances)
+		meshInstances.clear();
+	viewports.clear();
+}
+
+int LinkInstances::Add(const std::array<glm::mat4, 5>& models, float q2, const glm::vec3& lengths, int viewport)
+{
+	int robot = GetRobotCount();
+
+	// links are unit cylinders stretched along their local Z
+	const float linkLengths[] = { lengths.x, q2, lengths.y, lengths.z };
+	auto& cylinders = instances[(int)LinkMesh::Cylinder];
+	for (int i = 0; i < 4; i++) {
+		glm::mat4 model = models[i] * glm::scale(glm::mat4(1.f), glm::vec3(1.f, 1.f, linkLengths[i]));
+		cylinders.emplace_back(model, colors[(int)LinkMesh::Cylinder]);
+	}
+
+	// joints F1..F4, the effector only gets the pointers
+	auto& spheres = instances[(int)LinkMesh::Sphere];
+	for (int i = 0; i < 4; i++)
+		spheres.emplace_back(models[i], colors[(int)LinkMesh::Sphere]);
+
+	for (LinkMesh pointer : { LinkMesh::PointerX, LinkMesh::PointerY, LinkMesh::PointerZ })
+		instances[(int)pointer].emplace_back(models[4], colors[(int)pointer]);
+
+	viewports.push_back(viewport);
+	return robot;
+}
+
+void LinkInstances::Upload(GLuint instanceBinding, GLuint viewportBinding)
+{
+	packed.clear();
+	packedViewports.clear();
+	for (int mesh = 0; mesh < linkMeshCount; mesh++) {
+		packed.insert(packed.end(), instances[mesh].begin(), instances[mesh].end());
+		for (int viewport : viewports)
+			packedViewports.insert(packedViewports.end(), perRobot[mesh], viewport);
+	}
+
+	ssbo.ReplaceBufferData(packed.data(), packed.size() * sizeof(LinkInstance));
+	ssbo.Bind(instanceBinding);
+	viewportSsbo.ReplaceBufferData(packedViewports.data(), packedViewports.size() * sizeof(GLint));
+	viewportSsbo.Bind(viewportBinding);
+}
+
+void LinkInstances::Delete()
+{
+	ssbo.Delete();
+	viewportSsbo.Delete();
+}
+
+int LinkInstances::GetRobotCount() const
+{
+	return (int)viewports.size();
+}
+
+GLuint LinkInstances::GetBaseInstance(LinkMesh mesh, int firstRobot) const
+{
+	GLuint base = 0;
+	for (int i = 0; i < (int)mesh; i++)
+		base += (GLuint)instances[i].size();
+	return base + perRobot[(int)mesh] * firstRobot;
+}
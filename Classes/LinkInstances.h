@@ -0,0 +1,60 @@
+#pragma once
+
+#include "SSBO.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <vector>
+
+// Meshes a robot is drawn with, in the order their instance ranges are laid out
+enum class LinkMesh {
+	Cylinder,
+	Sphere,
+	PointerX,
+	PointerY,
+	PointerZ,
+	Count
+};
+
+constexpr int linkMeshCount = (int)LinkMesh::Count;
+
+// std430 layout of one instance, the mat3 columns are padded to vec4.
+// The normal matrix is precomputed, so the vertex shader never inverts a matrix.
+struct LinkInstance {
+	glm::mat4 model;
+	glm::mat3x4 normalMatrix;
+	glm::vec4 color;
+
+	LinkInstance(const glm::mat4& model, const glm::vec4& color);
+};
+
+// Instances of every robot drawn in a frame, grouped by mesh so each mesh is covered by a single indirect command
+// per viewport. The buffer holds all cylinders, then all spheres, then the pointers of each axis.
+// A parallel buffer holds the viewport index of every instance for single-pass multi-viewport rendering.
+class LinkInstances
+{
+private:
+	static constexpr std::array<int, linkMeshCount> perRobot = { 4, 4, 1, 1, 1 };
+
+	std::array<glm::vec4, linkMeshCount> colors;
+	std::array<std::vector<LinkInstance>, linkMeshCount> instances;
+	std::vector<int> viewports;
+	std::vector<LinkInstance> packed;
+	std::vector<GLint> packedViewports;
+	SSBO ssbo;
+	SSBO viewportSsbo;
+
+public:
+	LinkInstances(const std::array<glm::vec4, linkMeshCount>& colors);
+
+	void Clear();
+	// returns the index of the added robot, viewport is the index in the viewport array it is drawn to
+	int Add(const std::array<glm::mat4, 5>& models, float q2, const glm::vec3& lengths, int viewport = 0);
+	// uploads all instances at once and binds them and their viewport indices to the given SSBO binding points
+	void Upload(GLuint instanceBinding, GLuint viewportBinding);
+	void Delete();
+
+	int GetRobotCount() const;
+	// first instance and instance count of robots [firstRobot, firstRobot + robotCount) for one mesh
+	GLuint GetBaseInstance(LinkMesh mesh, int firstRobot) const;
+	static GLuint GetInstanceCount(LinkMesh mesh, int robotCount) { return perRobot[(int)mesh] * robotCount; }
+};
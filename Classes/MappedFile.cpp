@@ -0,0 +1,104 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) : data(nullptr), size(0), file(nullptr), mapping(nullptr)
+{
+#if defined(_WIN32)
+	HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("Failed to open file " + path);
+	file = fileHandle;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize)) {
+		Close();
+		throw std::runtime_error("Failed to read the size of " + path);
+	}
+	size = (size_t)fileSize.QuadPart;
+	// empty files cannot be mapped
+	if (size == 0)
+		return;
+
+	mapping = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping != NULL)
+		data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr) {
+		Close();
+		throw std::runtime_error("Failed to map file " + path);
+	}
+#else
+	int descriptor = open(path.c_str(), O_RDONLY);
+	if (descriptor < 0)
+		throw std::runtime_error("Failed to open file " + path);
+
+	struct stat status;
+	if (fstat(descriptor, &status) != 0) {
+		close(descriptor);
+		throw std::runtime_error("Failed to read the size of " + path);
+	}
+	size = (size_t)status.st_size;
+	if (size == 0) {
+		close(descriptor);
+		return;
+	}
+
+	void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	close(descriptor);
+	if (view == MAP_FAILED)
+		throw std::runtime_error("Failed to map file " + path);
+	madvise(view, size, MADV_SEQUENTIAL);
+	data = (const char*)view;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	: data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)),
+	file(std::exchange(other.file, nullptr)), mapping(std::exchange(other.mapping, nullptr)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other) {
+		Close();
+		data = std::exchange(other.data, nullptr);
+		size = std::exchange(other.size, 0);
+		file = std::exchange(other.file, nullptr);
+		mapping = std::exchange(other.mapping, nullptr);
+	}
+	return *this;
+}
+
+void MappedFile::Close()
+{
+#if defined(_WIN32)
+	if (data != nullptr)
+		UnmapViewOfFile(data);
+	if (mapping != nullptr)
+		CloseHandle(mapping);
+	if (file != nullptr)
+		CloseHandle(file);
+#else
+	if (data != nullptr)
+		munmap((void*)data, size);
+#endif
+	data = nullptr;
+	mapping = nullptr;
+	file = nullptr;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+// Read-only memory mapping of a whole file, throws std::runtime_error when the file cannot be mapped
+class MappedFile
+{
+private:
+	const char* data;
+	size_t size;
+	// file and mapping handles on Windows, the descriptor is closed right after mapping elsewhere
+	void* file;
+	void* mapping;
+
+	void Close();
+
+public:
+	// empty mapping, GetData returns nullptr
+	MappedFile() : data(nullptr), size(0), file(nullptr), mapping(nullptr) {}
+	explicit MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	const char* GetData() const { return data; }
+	size_t GetSize() const { return size; }
+};
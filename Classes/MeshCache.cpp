@@ -0,0 +1,166 @@
+#include "MeshCache.h"
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+static const char meshCacheMagic[4] = { 'P', 'M', 'S', 'H' };
+static const uint32_t meshCacheVersion = 1;
+
+// 64-bit FNV-1a
+static uint64_t hashBytes(const char* data, size_t size)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= (unsigned char)data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+static uint64_t hashFile(const std::string& path)
+{
+	MappedFile file(path);
+	return hashBytes(file.GetData(), file.GetSize());
+}
+
+static int64_t modificationTime(const std::string& path)
+{
+	return (int64_t)fs::last_write_time(path).time_since_epoch().count();
+}
+
+static bool isCompatible(const MappedFile& cache)
+{
+	if (cache.GetSize() < sizeof(MeshCacheHeader))
+		return false;
+
+	const MeshCacheHeader* header = (const MeshCacheHeader*)cache.GetData();
+	return memcmp(header->magic, meshCacheMagic, sizeof(meshCacheMagic)) == 0
+		&& header->version == meshCacheVersion
+		&& header->vertexStride == sizeof(VertexStruct)
+		&& cache.GetSize() == sizeof(MeshCacheHeader)
+			+ (size_t)header->vertexCount * sizeof(VertexStruct) + (size_t)header->indexCount * sizeof(GLuint);
+}
+
+// Patches the source mtime of a cache in place, the rest of it stays as it is
+static bool refreshSourceTime(const std::string& cachePath, int64_t sourceTime)
+{
+	std::fstream file(cachePath, std::ios::in | std::ios::out | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	file.seekp(offsetof(MeshCacheHeader, sourceTime));
+	file.write((const char*)&sourceTime, sizeof(sourceTime));
+	return file.good();
+}
+
+MeshData MeshCache::Load(const std::string& objPath, ParseStats* stats)
+{
+	const std::string cachePath = GetPath(objPath);
+	const uint64_t sourceSize = (uint64_t)fs::file_size(objPath);
+	const int64_t sourceTime = modificationTime(objPath);
+	uint64_t sourceHash = 0;
+	bool hashed = false;
+
+	if (fs::exists(cachePath)) {
+		try {
+			MappedFile cache(cachePath);
+			if (isCompatible(cache)) {
+				const MeshCacheHeader header = *(const MeshCacheHeader*)cache.GetData();
+
+				// a checkout or copy changes the mtime but not the content
+				bool valid = header.sourceSize == sourceSize && header.sourceTime == sourceTime;
+				if (!valid && header.sourceSize == sourceSize) {
+					sourceHash = hashFile(objPath);
+					hashed = true;
+					valid = header.sourceHash == sourceHash;
+
+					// so the next load takes the size and mtime path again, the mapping keeps the file locked on
+					// Windows, so it is patched unmapped and mapped anew
+					if (valid) {
+						cache = MappedFile();
+						if (!refreshSourceTime(cachePath, sourceTime))
+							std::cout << "Failed to update mesh cache " << cachePath << std::endl;
+						cache = MappedFile(cachePath);
+						valid = isCompatible(cache);
+					}
+				}
+
+				if (valid) {
+					if (stats != nullptr) {
+						stats->cornerCount = header.cornerCount;
+						stats->vertexCount = header.vertexCount;
+						stats->acmrBefore = header.acmrBefore;
+						stats->acmrAfter = header.acmrAfter;
+						stats->cached = true;
+					}
+
+					const size_t vertexOffset = sizeof(MeshCacheHeader);
+					const size_t indexOffset = vertexOffset + (size_t)header.vertexCount * sizeof(VertexStruct);
+					return MeshData(std::move(cache), vertexOffset, header.vertexCount, indexOffset, header.indexCount);
+				}
+			}
+		}
+		catch (const std::runtime_error&) {
+			// an unreadable cache is rebuilt below
+		}
+	}
+
+	ParseStats parseStats;
+	MeshData mesh(Parser::ParseObj(objPath, &parseStats));
+	if (stats != nullptr)
+		*stats = parseStats;
+
+	MeshCacheHeader header;
+	memcpy(header.magic, meshCacheMagic, sizeof(meshCacheMagic));
+	header.version = meshCacheVersion;
+	header.vertexStride = sizeof(VertexStruct);
+	header.vertexCount = (uint32_t)mesh.GetVertexCount();
+	header.indexCount = (uint32_t)mesh.GetIndexCount();
+	header.cornerCount = (uint32_t)parseStats.cornerCount;
+	header.acmrBefore = parseStats.acmrBefore;
+	header.acmrAfter = parseStats.acmrAfter;
+	header.sourceSize = sourceSize;
+	header.sourceTime = sourceTime;
+	header.sourceHash = hashed ? sourceHash : hashFile(objPath);
+
+	if (!Write(cachePath, header, mesh))
+		std::cout << "Failed to write mesh cache " << cachePath << std::endl;
+
+	return mesh;
+}
+
+std::string MeshCache::GetPath(const std::string& objPath)
+{
+	return fs::path(objPath).replace_extension(".mesh").string();
+}
+
+bool MeshCache::Write(const std::string& cachePath, const MeshCacheHeader& header, const MeshData& mesh)
+{
+	// written aside and renamed, so a crash never leaves a truncated cache behind
+	const std::string tempPath = cachePath + ".tmp";
+	bool written;
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return false;
+
+		file.write((const char*)&header, sizeof(header));
+		file.write((const char*)mesh.GetVertices(), mesh.GetVertexCount() * sizeof(VertexStruct));
+		file.write((const char*)mesh.GetIndices(), mesh.GetIndexCount() * sizeof(GLuint));
+		written = file.good();
+	}
+
+	std::error_code error;
+	if (written)
+		fs::rename(tempPath, cachePath, error);
+	if (!written || error) {
+		fs::remove(tempPath, error);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "MeshData.h"
+#include "Parser.h"
+#include <cstdint>
+#include <string>
+
+// Layout of a .mesh file: this header, vertexCount VertexStructs, then indexCount indices
+struct MeshCacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t vertexStride;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	// ParseStats of the parse that produced the cache
+	uint32_t cornerCount;
+	float acmrBefore;
+	float acmrAfter;
+	// source OBJ the cache was built from
+	uint64_t sourceSize;
+	int64_t sourceTime;
+	uint64_t sourceHash;
+};
+
+// Binary copy of a parsed and optimised OBJ, written next to it on the first load and memory mapped afterwards.
+// The cache is used while the OBJ keeps its size and modification time, or failing that, its content hash.
+class MeshCache
+{
+public:
+	static MeshData Load(const std::string& objPath, ParseStats* stats = nullptr);
+
+	// <name>.obj -> <name>.mesh
+	static std::string GetPath(const std::string& objPath);
+
+	// returns false when the file could not be written
+	static bool Write(const std::string& cachePath, const MeshCacheHeader& header, const MeshData& mesh);
+};
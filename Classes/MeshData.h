@@ -0,0 +1,50 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "VertexStruct.h"
+#include <glad/glad.h>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Vertex and index blocks of one mesh, either owned or pointing into a memory-mapped mesh cache.
+// Both kinds are uploaded straight from these blocks.
+class MeshData
+{
+private:
+	std::vector<VertexStruct> ownedVertices;
+	std::vector<GLuint> ownedIndices;
+	MappedFile file;
+
+	const VertexStruct* vertices;
+	size_t vertexCount;
+	const GLuint* indices;
+	size_t indexCount;
+
+public:
+	MeshData(std::tuple<std::vector<VertexStruct>, std::vector<GLuint>>&& mesh)
+		: ownedVertices(std::move(std::get<0>(mesh))), ownedIndices(std::move(std::get<1>(mesh)))
+	{
+		vertices = ownedVertices.data();
+		vertexCount = ownedVertices.size();
+		indices = ownedIndices.data();
+		indexCount = ownedIndices.size();
+	}
+
+	// offsets are in bytes from the start of the file
+	MeshData(MappedFile&& mappedFile, size_t vertexOffset, size_t vertexCount, size_t indexOffset, size_t indexCount)
+		: file(std::move(mappedFile)), vertexCount(vertexCount), indexCount(indexCount)
+	{
+		vertices = (const VertexStruct*)(file.GetData() + vertexOffset);
+		indices = (const GLuint*)(file.GetData() + indexOffset);
+	}
+
+	// moving vectors and mappings keeps the block addresses
+	MeshData(MeshData&&) = default;
+	MeshData& operator=(MeshData&&) = default;
+
+	const VertexStruct* GetVertices() const { return vertices; }
+	size_t GetVertexCount() const { return vertexCount; }
+	const GLuint* GetIndices() const { return indices; }
+	size_t GetIndexCount() const { return indexCount; }
+};
@@ -0,0 +1,13 @@
+#include "MeshLoader.h"
+
+MeshLoader::MeshLoader(const std::vector<std::string>& paths) : slots(paths.size()), collectedCount(0), failedCount(0)
+{
+	for (size_t i = 0; i < paths.size(); i++) {
+		Slot& slot = slots[i];
+		slot.path = paths[i];
+		ParseStats* stats = &slot.stats;
+		slot.mesh = std::async(std::launch::async, [path = paths[i], stats]() {
+			return MeshCache::Load(path, stats);
+		});
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "MeshCache.h"
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+// Loads meshes through MeshCache on background threads, one per mesh. Nothing there touches OpenGL,
+// the thread owning the context collects finished meshes with Poll and uploads them itself.
+class MeshLoader
+{
+private:
+	struct Slot {
+		std::string path;
+		std::future<MeshData> mesh;
+		// written by the loading thread, read after the future is ready
+		ParseStats stats;
+		bool collected = false;
+		std::string error;
+	};
+
+	// never resized after the loads start, the threads keep pointers to the stats
+	std::vector<Slot> slots;
+	size_t collectedCount;
+	size_t failedCount;
+
+public:
+	explicit MeshLoader(const std::vector<std::string>& paths);
+
+	// Calls upload(index, mesh, stats) for every mesh that finished loading since the last call, on the calling thread.
+	// Meshes that failed are only recorded, see GetError.
+	template <typename Upload>
+	void Poll(Upload upload)
+	{
+		for (size_t i = 0; i < slots.size(); i++) {
+			Slot& slot = slots[i];
+			if (slot.collected || slot.mesh.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+				continue;
+
+			slot.collected = true;
+			collectedCount++;
+			try {
+				MeshData mesh = slot.mesh.get();
+				upload(i, mesh, slot.stats);
+			}
+			catch (const std::exception& e) {
+				slot.error = e.what();
+				failedCount++;
+			}
+		}
+	}
+
+	size_t GetCount() const { return slots.size(); }
+	// meshes handed out by Poll, failed ones included
+	size_t GetCollectedCount() const { return collectedCount; }
+	bool IsDone() const { return collectedCount == slots.size(); }
+	bool HasFailed() const { return failedCount > 0; }
+	const std::string& GetPath(size_t index) const { return slots[index].path; }
+	// empty unless the mesh failed to load
+	const std::string& GetError(size_t index) const { return slots[index].error; }
+};
@@ -0,0 +1,177 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const int cacheSize = 32;
+	const float cacheDecayPower = 1.5f;
+	const float lastTriangleScore = 0.75f;
+	const float valenceBoostScale = 2.f;
+	const float valenceBoostPower = 0.5f;
+
+	float vertexScore(int cachePosition, int remainingTriangles)
+	{
+		// no triangle needs the vertex any more
+		if (remainingTriangles == 0)
+			return -1.f;
+
+		float score = 0.f;
+		if (cachePosition >= 0) {
+			if (cachePosition < 3) {
+				// the vertices of the last triangle get a fixed score, so its neighbours are not always preferred
+				score = lastTriangleScore;
+			}
+			else {
+				float scaler = 1.f / (cacheSize - 3);
+				score = std::pow(1.f - (cachePosition - 3) * scaler, cacheDecayPower);
+			}
+		}
+
+		// boost vertices with few remaining triangles, so lone triangles are not left behind
+		score += valenceBoostScale * std::pow((float)remainingTriangles, -valenceBoostPower);
+		return score;
+	}
+}
+
+void optimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+		return;
+
+	// triangles adjacent to each vertex, in compressed row storage
+	std::vector<int> remaining(vertexCount, 0);
+	for (GLuint index : indices)
+		remaining[index]++;
+
+	std::vector<size_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++)
+		adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remaining[v];
+
+	std::vector<size_t> adjacency(indices.size());
+	std::vector<size_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (size_t t = 0; t < triangleCount; t++) {
+		for (int k = 0; k < 3; k++)
+			adjacency[fill[indices[3 * t + k]]++] = t;
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> score(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++)
+		score[v] = vertexScore(-1, remaining[v]);
+
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	for (size_t t = 0; t < triangleCount; t++)
+		triangleScore[t] = score[indices[3 * t]] + score[indices[3 * t + 1]] + score[indices[3 * t + 2]];
+
+	std::vector<GLuint> result;
+	result.reserve(indices.size());
+	// one extra slot for the vertices pushed out by the newest triangle
+	std::vector<GLuint> cache;
+	cache.reserve(cacheSize + 3);
+	std::vector<GLuint> newCache;
+	newCache.reserve(cacheSize + 3);
+
+	size_t scanCursor = 0;
+	size_t best = 0;
+	float bestScore = triangleScore[0];
+	for (size_t t = 1; t < triangleCount; t++) {
+		if (triangleScore[t] > bestScore) {
+			best = t;
+			bestScore = triangleScore[t];
+		}
+	}
+
+	for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+		if (bestScore < 0.f) {
+			// nothing in the cache touches an open triangle, fall back to the first one left
+			while (emitted[scanCursor])
+				scanCursor++;
+			best = scanCursor;
+		}
+
+		const GLuint* triangle = &indices[3 * best];
+		emitted[best] = true;
+		result.insert(result.end(), triangle, triangle + 3);
+
+		// the emitted triangle goes to the front of the LRU cache
+		newCache.assign(triangle, triangle + 3);
+		for (GLuint vertex : cache) {
+			if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+				newCache.push_back(vertex);
+		}
+
+		for (int k = 0; k < 3; k++) {
+			GLuint vertex = triangle[k];
+			size_t begin = adjacencyOffsets[vertex];
+			size_t end = begin + remaining[vertex];
+			auto found = std::find(adjacency.begin() + begin, adjacency.begin() + end, best);
+			std::iter_swap(found, adjacency.begin() + end - 1);
+			remaining[vertex]--;
+		}
+
+		for (size_t i = 0; i < newCache.size(); i++) {
+			GLuint vertex = newCache[i];
+			cachePosition[vertex] = i < (size_t)cacheSize ? (int)i : -1;
+			score[vertex] = vertexScore(cachePosition[vertex], remaining[vertex]);
+		}
+
+		// only triangles around cached vertices changed their score
+		bestScore = -1.f;
+		for (GLuint vertex : newCache) {
+			size_t begin = adjacencyOffsets[vertex];
+			for (size_t a = begin; a < begin + remaining[vertex]; a++) {
+				size_t t = adjacency[a];
+				triangleScore[t] = score[indices[3 * t]] + score[indices[3 * t + 1]] + score[indices[3 * t + 2]];
+				if (triangleScore[t] > bestScore) {
+					best = t;
+					bestScore = triangleScore[t];
+				}
+			}
+		}
+
+		if (newCache.size() > (size_t)cacheSize)
+			newCache.resize(cacheSize);
+		std::swap(cache, newCache);
+	}
+
+	indices.swap(result);
+}
+
+void optimizeVertexFetch(std::vector<VertexStruct>& vertices, std::vector<GLuint>& indices)
+{
+	const GLuint unused = ~0u;
+	std::vector<GLuint> remap(vertices.size(), unused);
+	std::vector<VertexStruct> reordered;
+	reordered.reserve(vertices.size());
+
+	for (GLuint& index : indices) {
+		if (remap[index] == unused) {
+			remap[index] = (GLuint)reordered.size();
+			reordered.push_back(vertices[index]);
+		}
+		index = remap[index];
+	}
+
+	vertices.swap(reordered);
+}
+
+float calculateACMR(const std::vector<GLuint>& indices, size_t vertexCount, int cacheSize)
+{
+	if (indices.empty())
+		return 0.f;
+
+	// timestamps of the FIFO insertions, a vertex is cached while fewer than cacheSize misses happened since
+	std::vector<size_t> insertedAt(vertexCount, 0);
+	size_t misses = 0;
+	for (GLuint index : indices) {
+		if (insertedAt[index] == 0 || misses - insertedAt[index] + 1 > (size_t)cacheSize) {
+			misses++;
+			insertedAt[index] = misses;
+		}
+	}
+
+	return (float)misses / (indices.size() / 3);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "VertexStruct.h"
+#include <glad/glad.h>
+#include <vector>
+
+// Reorders triangles for the post-transform vertex cache with Tom Forsyth's "Linear-Speed Vertex Cache
+// Optimisation": greedily emits the triangle whose vertices score best given an LRU model of the cache.
+void optimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount);
+
+// Renumbers vertices in order of first use, so vertex fetches walk the buffer linearly
+void optimizeVertexFetch(std::vector<VertexStruct>& vertices, std::vector<GLuint>& indices);
+
+// Average transformed vertices per triangle for a FIFO cache of the given size, 3 is the worst case, ~0.5 the best
+float calculateACMR(const std::vector<GLuint>& indices, size_t vertexCount, int cacheSize = 16);
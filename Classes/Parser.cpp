@@ -0,0 +1,456 @@
+#include "Parser.h"
+#include "MappedFile.h"
+#include "parallel.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+	// one line of the file without its terminator
+	struct Line {
+		const char* begin;
+		const char* end;
+		int number;
+	};
+
+	bool isSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	void skipSpaces(const char*& p, const char* end)
+	{
+		while (p < end && isSpace(*p))
+			p++;
+	}
+
+	// the record keyword, e.g. "v", "vn" or "f"
+	std::pair<const char*, size_t> readKeyword(const char*& p, const char* end)
+	{
+		const char* begin = p;
+		while (p < end && !isSpace(*p))
+			p++;
+		return { begin, (size_t)(p - begin) };
+	}
+
+	bool keywordIs(const std::pair<const char*, size_t>& keyword, const char* name)
+	{
+		return keyword.second == strlen(name) && memcmp(keyword.first, name, keyword.second) == 0;
+	}
+
+	std::runtime_error lineError(const char* message, const Line& line)
+	{
+		return std::runtime_error(std::string(message) + " in line#" + std::to_string(line.number));
+	}
+
+	glm::vec3 readVec3(const char*& p, const Line& line)
+	{
+		glm::vec3 value;
+		for (int i = 0; i < 3; i++) {
+			skipSpaces(p, line.end);
+			auto result = std::from_chars(p, line.end, value[i]);
+			if (result.ec != std::errc())
+				throw lineError("Invalid number", line);
+			p = result.ptr;
+		}
+		return value;
+	}
+
+	// OBJ indices are 1-based, negative ones count back from the last element read so far
+	uint32_t resolveIndex(long index, size_t count, const Line& line)
+	{
+		long resolved = index < 0 ? (long)count + index : index - 1;
+		if (resolved < 0 || (size_t)resolved >= count)
+			throw lineError("Index out of range", line);
+		return (uint32_t)resolved;
+	}
+
+	// position and normal index of a "v//vn" or "v/vt/vn" corner
+	bool readCorner(const char*& p, const Line& line, long& position, long& normal)
+	{
+		skipSpaces(p, line.end);
+		if (p == line.end)
+			return false;
+
+		auto result = std::from_chars(p, line.end, position);
+		if (result.ec != std::errc() || result.ptr == line.end || *result.ptr != '/')
+			throw lineError("Invalid face substring", line);
+		p = result.ptr + 1;
+
+		// skip the texture coordinate index
+		while (p < line.end && *p != '/' && !isSpace(*p))
+			p++;
+		if (p == line.end || *p != '/')
+			throw lineError("Face corner without a normal", line);
+
+		result = std::from_chars(p + 1, line.end, normal);
+		if (result.ec != std::errc())
+			throw lineError("Invalid face substring", line);
+		p = result.ptr;
+		return true;
+	}
+
+	template <typename LineHandler>
+	void forEachLine(const char* begin, const char* end, int firstNumber, LineHandler handler)
+	{
+		int number = firstNumber;
+		for (const char* p = begin; p < end;) {
+			const char* newline = (const char*)memchr(p, '\n', end - p);
+			const char* lineEnd = newline != nullptr ? newline : end;
+			handler(Line{ p, lineEnd, number++ });
+			p = lineEnd + 1;
+		}
+	}
+
+	// Line-aligned slice of the file. The counts are filled by the first pass, the offsets of the chunk's
+	// first line/record in the whole file are their prefix sums.
+	struct Chunk {
+		const char* begin;
+		const char* end;
+		size_t lineCount = 0;
+		size_t positionCount = 0;
+		size_t normalCount = 0;
+		size_t faceCount = 0;
+		size_t cornerCount = 0;
+		size_t firstLine = 0;
+		size_t positionOffset = 0;
+		size_t normalOffset = 0;
+		size_t cornerOffset = 0;
+		// triangulated face corners as resolved position and normal indices, their number is only known after parsing
+		std::vector<uint32_t> cornerPositions;
+		std::vector<uint32_t> cornerNormals;
+		// exceptions cannot leave a worker thread, the first error in file order is rethrown after the join
+		std::string error;
+	};
+
+	const size_t minChunkSize = 256 * 1024;
+
+	std::vector<Chunk> splitLines(const char* data, size_t size, size_t chunkCount)
+	{
+		std::vector<Chunk> chunks;
+		const char* end = data + size;
+		const char* begin = data;
+		for (size_t i = 1; i <= chunkCount && begin < end; i++) {
+			const char* split = i == chunkCount ? end : data + size * i / chunkCount;
+			if (split < begin)
+				split = begin;
+			const char* newline = (const char*)memchr(split, '\n', end - split);
+			split = newline != nullptr ? newline + 1 : end;
+
+			Chunk chunk;
+			chunk.begin = begin;
+			chunk.end = split;
+			chunks.push_back(chunk);
+			begin = split;
+		}
+		return chunks;
+	}
+
+	void countRecords(Chunk& chunk)
+	{
+		forEachLine(chunk.begin, chunk.end, 0, [&](const Line& line) {
+			chunk.lineCount++;
+			const char* p = line.begin;
+			skipSpaces(p, line.end);
+			auto keyword = readKeyword(p, line.end);
+			if (keywordIs(keyword, "v")) {
+				chunk.positionCount++;
+			}
+			else if (keywordIs(keyword, "vn")) {
+				chunk.normalCount++;
+			}
+			else if (keywordIs(keyword, "f")) {
+				chunk.faceCount++;
+			}
+		});
+	}
+
+	// Writes the vertex records of the chunk at its offsets in the whole-file arrays and collects its face corners
+	void parseRecords(Chunk& chunk, std::vector<glm::vec3>& positions, std::vector<glm::vec3>& normals)
+	{
+		size_t position = chunk.positionOffset;
+		size_t normal = chunk.normalOffset;
+		chunk.cornerPositions.reserve(chunk.faceCount * 3);
+		chunk.cornerNormals.reserve(chunk.faceCount * 3);
+
+		auto addCorner = [&](const uint32_t (&indices)[2]) {
+			chunk.cornerPositions.push_back(indices[0]);
+			chunk.cornerNormals.push_back(indices[1]);
+		};
+
+		forEachLine(chunk.begin, chunk.end, (int)chunk.firstLine, [&](const Line& line) {
+			const char* p = line.begin;
+			skipSpaces(p, line.end);
+			if (p == line.end || *p == '#')
+				return;
+
+			auto keyword = readKeyword(p, line.end);
+			if (keywordIs(keyword, "v")) {
+				positions[position++] = readVec3(p, line);
+			}
+			else if (keywordIs(keyword, "vn")) {
+				normals[normal++] = readVec3(p, line);
+			}
+			else if (keywordIs(keyword, "f")) {
+				// polygons are triangulated as fans around the first corner,
+				// indices may only refer to elements of this or an earlier line
+				long positionIndex, normalIndex;
+				uint32_t first[2] = {}, previous[2] = {};
+				int cornerCount = 0;
+				while (readCorner(p, line, positionIndex, normalIndex)) {
+					uint32_t current[2] = { resolveIndex(positionIndex, position, line), resolveIndex(normalIndex, normal, line) };
+					if (cornerCount >= 2) {
+						addCorner(first);
+						addCorner(previous);
+						addCorner(current);
+					}
+					else if (cornerCount == 0) {
+						first[0] = current[0];
+						first[1] = current[1];
+					}
+					previous[0] = current[0];
+					previous[1] = current[1];
+					cornerCount++;
+				}
+				if (cornerCount < 3)
+					throw lineError("Face with less than 3 corners", line);
+			}
+			else if (!keywordIs(keyword, "vt") && !keywordIs(keyword, "o") && !keywordIs(keyword, "g") &&
+				!keywordIs(keyword, "s") && !keywordIs(keyword, "mtllib") && !keywordIs(keyword, "usemtl")) {
+				throw lineError("Invalid first substring", line);
+			}
+		});
+	}
+
+	uint64_t cornerKey(uint32_t position, uint32_t normal)
+	{
+		return ((uint64_t)position << 32) | normal;
+	}
+
+	uint64_t hashKey(uint64_t key)
+	{
+		return key * 0x9E3779B97F4A7C15ull;
+	}
+
+	// Open-addressing map from a corner key to the first corner with that key, linear probing, kept at most half full
+	class CornerTable
+	{
+	private:
+		static constexpr uint64_t emptyKey = ~0ull;
+		std::vector<uint64_t> keys;
+		std::vector<uint32_t> values;
+		size_t count = 0;
+		int bits = 0;
+
+		void Allocate(int tableBits)
+		{
+			bits = tableBits;
+			keys.assign((size_t)1 << bits, emptyKey);
+			values.resize((size_t)1 << bits);
+		}
+
+		void Grow()
+		{
+			std::vector<uint64_t> oldKeys = std::move(keys);
+			std::vector<uint32_t> oldValues = std::move(values);
+			Allocate(bits + 1);
+			count = 0;
+			for (size_t i = 0; i < oldKeys.size(); i++) {
+				if (oldKeys[i] != emptyKey)
+					FindOrInsert(oldKeys[i], oldValues[i]);
+			}
+		}
+
+	public:
+		explicit CornerTable(size_t expectedCount)
+		{
+			int tableBits = 4;
+			while (((size_t)1 << tableBits) < expectedCount * 2)
+				tableBits++;
+			Allocate(tableBits);
+		}
+
+		// returns the value stored for key, storing value first if the key is new
+		uint32_t FindOrInsert(uint64_t key, uint32_t value)
+		{
+			if (2 * (count + 1) > keys.size())
+				Grow();
+
+			const size_t mask = keys.size() - 1;
+			for (size_t i = (size_t)(hashKey(key) >> (64 - bits));; i = (i + 1) & mask) {
+				if (keys[i] == key)
+					return values[i];
+				if (keys[i] == emptyKey) {
+					keys[i] = key;
+					values[i] = value;
+					count++;
+					return value;
+				}
+			}
+		}
+	};
+
+	// runs body(chunk) for every chunk on the parallelFor threads and rethrows the first error in file order
+	template <typename Body>
+	void forEachChunk(std::vector<Chunk>& chunks, Body body)
+	{
+		parallelFor(chunks.size(), [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; i++) {
+				try {
+					body(chunks[i]);
+				}
+				catch (const std::exception& e) {
+					chunks[i].error = e.what();
+				}
+			}
+		});
+
+		for (const Chunk& chunk : chunks) {
+			if (!chunk.error.empty())
+				throw std::runtime_error(chunk.error);
+		}
+	}
+}
+
+std::tuple<std::vector<VertexStruct>, std::vector<GLuint>> Parser::ReadObj(const std::string& path, unsigned threadCount)
+{
+	MappedFile file(path);
+	const char* data = file.GetData();
+	const size_t size = file.GetSize();
+
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threadCount, size / minChunkSize));
+	std::vector<Chunk> chunks = splitLines(data, size, chunkCount);
+	chunkCount = chunks.size();
+
+	// count the vertex records of every chunk, their prefix sums place each chunk in the output arrays
+	forEachChunk(chunks, countRecords);
+	size_t lineCount = 0, positionCount = 0, normalCount = 0;
+	for (Chunk& chunk : chunks) {
+		chunk.firstLine = lineCount + 1;
+		chunk.positionOffset = positionCount;
+		chunk.normalOffset = normalCount;
+		lineCount += chunk.lineCount;
+		positionCount += chunk.positionCount;
+		normalCount += chunk.normalCount;
+	}
+
+	std::vector<glm::vec3> positions(positionCount);
+	std::vector<glm::vec3> normals(normalCount);
+	forEachChunk(chunks, [&](Chunk& chunk) {
+		parseRecords(chunk, positions, normals);
+	});
+
+	// stitch the face corners of all chunks together
+	size_t cornerCount = 0;
+	for (Chunk& chunk : chunks) {
+		chunk.cornerOffset = cornerCount;
+		chunk.cornerCount = chunk.cornerPositions.size();
+		cornerCount += chunk.cornerCount;
+	}
+	std::vector<uint32_t> cornerPositions(cornerCount);
+	std::vector<uint32_t> cornerNormals(cornerCount);
+	forEachChunk(chunks, [&](Chunk& chunk) {
+		std::copy(chunk.cornerPositions.begin(), chunk.cornerPositions.end(), cornerPositions.begin() + chunk.cornerOffset);
+		std::copy(chunk.cornerNormals.begin(), chunk.cornerNormals.end(), cornerNormals.begin() + chunk.cornerOffset);
+		chunk.cornerPositions = std::vector<uint32_t>();
+		chunk.cornerNormals = std::vector<uint32_t>();
+	});
+
+	// Deduplication keeps the first corner of every (position, normal) pair. Keys are sharded by hash,
+	// each shard visits its corners in file order, so representative[c] is the first corner equal to c.
+	const size_t shardCount = chunkCount;
+	auto shardOf = [shardCount](uint64_t key) {
+		return (size_t)(hashKey(key) >> 32) % shardCount;
+	};
+
+	// shardCorners[chunk * shardCount + shard] lists the corners of the chunk that belong to the shard
+	std::vector<std::vector<uint32_t>> shardCorners(shardCount > 1 ? chunkCount * shardCount : 0);
+	if (shardCount > 1) {
+		forEachChunk(chunks, [&](const Chunk& chunk) {
+			size_t chunkIndex = &chunk - chunks.data();
+			for (size_t c = chunk.cornerOffset; c < chunk.cornerOffset + chunk.cornerCount; c++)
+				shardCorners[chunkIndex * shardCount + shardOf(cornerKey(cornerPositions[c], cornerNormals[c]))].push_back((uint32_t)c);
+		});
+	}
+
+	std::vector<uint32_t> representative(cornerCount);
+	parallelFor(shardCount, [&](size_t begin, size_t end) {
+		for (size_t shard = begin; shard < end; shard++) {
+			// most meshes have about one vertex per position
+			CornerTable firstCorners(positionCount / shardCount + 1);
+			auto visit = [&](uint32_t c) {
+				representative[c] = firstCorners.FindOrInsert(cornerKey(cornerPositions[c], cornerNormals[c]), c);
+			};
+
+			if (shardCount == 1) {
+				for (size_t c = 0; c < cornerCount; c++)
+					visit((uint32_t)c);
+			}
+			else {
+				for (size_t chunk = 0; chunk < chunkCount; chunk++)
+					for (uint32_t c : shardCorners[chunk * shardCount + shard])
+						visit(c);
+			}
+		}
+	});
+	shardCorners.clear();
+
+	// first corners become vertices in file order, numbered by the prefix sum of their counts per chunk
+	std::vector<size_t> vertexOffsets(chunkCount + 1, 0);
+	for (size_t i = 0; i < chunkCount; i++) {
+		size_t firstCount = 0;
+		for (size_t c = chunks[i].cornerOffset; c < chunks[i].cornerOffset + chunks[i].cornerCount; c++)
+			firstCount += representative[c] == c;
+		vertexOffsets[i + 1] = vertexOffsets[i] + firstCount;
+	}
+
+	std::vector<VertexStruct> vertices(vertexOffsets[chunkCount]);
+	std::vector<GLuint> indices(cornerCount);
+	// first corners keep their vertex in their own index slot, duplicates copy it once all of those are written
+	forEachChunk(chunks, [&](const Chunk& chunk) {
+		GLuint vertex = (GLuint)vertexOffsets[&chunk - chunks.data()];
+		for (size_t c = chunk.cornerOffset; c < chunk.cornerOffset + chunk.cornerCount; c++) {
+			if (representative[c] == c) {
+				vertices[vertex].position = positions[cornerPositions[c]];
+				vertices[vertex].normal = normals[cornerNormals[c]];
+				indices[c] = vertex++;
+			}
+		}
+	});
+	forEachChunk(chunks, [&](const Chunk& chunk) {
+		for (size_t c = chunk.cornerOffset; c < chunk.cornerOffset + chunk.cornerCount; c++) {
+			if (representative[c] != c)
+				indices[c] = indices[representative[c]];
+		}
+	});
+
+	return std::make_tuple(std::move(vertices), std::move(indices));
+}
+
+std::tuple<std::vector<VertexStruct>, std::vector<GLuint>> Parser::ParseObj(const std::string& path, ParseStats* stats)
+{
+	auto mesh = ReadObj(path);
+	std::vector<VertexStruct>& vertices = std::get<0>(mesh);
+	std::vector<GLuint>& indices = std::get<1>(mesh);
+
+	if (stats != nullptr) {
+		stats->cornerCount = indices.size();
+		stats->acmrBefore = calculateACMR(indices, vertices.size());
+	}
+
+	optimizeVertexCache(indices, vertices.size());
+	optimizeVertexFetch(vertices, indices);
+
+	if (stats != nullptr) {
+		stats->vertexCount = vertices.size();
+		stats->acmrAfter = calculateACMR(indices, vertices.size());
+	}
+
+	return mesh;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Bounded lock-free single-producer single-consumer ring buffer, Capacity has to be a power of two
+template <typename T, size_t Capacity>
+class SPSCQueue
+{
+private:
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+
+	std::array<T, Capacity> items;
+	// next slot to pop, written by the consumer
+	alignas(64) std::atomic<size_t> head;
+	// next slot to push, written by the producer
+	alignas(64) std::atomic<size_t> tail;
+
+public:
+	SPSCQueue() : items(), head(0), tail(0) {}
+
+	// false when the queue is full
+	bool Push(const T& item) {
+		size_t currentTail = tail.load(std::memory_order_relaxed);
+		if (currentTail - head.load(std::memory_order_acquire) == Capacity)
+			return false;
+
+		items[currentTail & (Capacity - 1)] = item;
+		tail.store(currentTail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// false when the queue is empty
+	bool Pop(T& item) {
+		size_t currentHead = head.load(std::memory_order_relaxed);
+		if (currentHead == tail.load(std::memory_order_acquire))
+			return false;
+
+		item = items[currentHead & (Capacity - 1)];
+		head.store(currentHead + 1, std::memory_order_release);
+		return true;
+	}
+};
@@ -0,0 +1,26 @@
+#include "SSBO.h"
+
+SSBO::SSBO() : capacity(0)
+{
+	glGenBuffers(1, &ID);
+}
+
+void SSBO::Bind(GLuint binding)
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, ID);
+}
+
+void SSBO::Delete()
+{
+	glDeleteBuffers(1, &ID);
+}
+
+void SSBO::ReplaceBufferData(const void* data, GLsizeiptr size)
+{
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ID);
+	if (size > capacity)
+		capacity = size;
+	glBufferData(GL_SHADER_STORAGE_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
@@ -0,0 +1,20 @@
+#ifndef SSBO_CLASS_H
+#define SSBO_CLASS_H
+
+#include "glad/glad.h"
+
+class SSBO
+{
+public:
+	GLuint ID;
+	SSBO();
+
+	void Bind(GLuint binding);
+	void Delete();
+	// grows the storage when needed and otherwise orphans it, so the driver never waits for the previous frame
+	void ReplaceBufferData(const void* data, GLsizeiptr size);
+
+private:
+	GLsizeiptr capacity;
+};
+#endif
@@ -1,5 +1,6 @@
 #include"Shader.h"
 
+#include <stdexcept>
 #include <vector>
 
 std::string get_file_contents(const char* filename)
@@ -18,6 +19,36 @@ std::string get_file_contents(const char* filename)
 	throw(errno);
 }
 
+// GLSL has no includes, so every line of the form #include "name" is replaced by the contents of the file name next to the
+// including shader. This is how the shaders share the FrameUniforms block. Line numbers of errors after an include
+// are kept right by a #line directive.
+static std::string resolveIncludes(const std::string& code, const std::string& file)
+{
+	const size_t separator = file.find_last_of("\\/");
+	const std::string directory = separator == std::string::npos ? "" : file.substr(0, separator + 1);
+
+	std::istringstream in(code);
+	std::ostringstream out;
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(in, line)) {
+		lineNumber++;
+		size_t start = line.find_first_not_of(" \t");
+		if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+			out << line << '\n';
+			continue;
+		}
+
+		size_t open = line.find('"', start);
+		size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+		if (close == std::string::npos)
+			throw std::runtime_error(file + ": malformed #include in line#" + std::to_string(lineNumber));
+		out << get_file_contents((directory + line.substr(open + 1, close - open - 1)).c_str()) << '\n';
+		out << "#line " << lineNumber + 1 << '\n';
+	}
+	return out.str();
+}
+
 Shader::Shader(const char *vertexFile, const char *fragmentFile,
                const char *tcFile, const char *teFile) {
 	std::vector<GLuint> shaders;
@@ -75,7 +106,7 @@ void Shader::compileErrors(unsigned int shader, const char *type)
 }
 
 GLuint Shader::compileShader(GLenum type, const char *file) {
-  std::string code = get_file_contents(file);
+  std::string code = resolveIncludes(get_file_contents(file), file);
   const char *source = code.c_str();
 
   GLuint shader = glCreateShader(type);
@@ -0,0 +1,101 @@
+#define _USE_MATH_DEFINES
+#include "Simulation.h"
+#include <algorithm>
+
+Simulation::Simulation() :
+	tickLength(1.f / defaultTickRate), baseTime(0.f), tick(0),
+	joints(glm::vec3(0.f), glm::vec3(0.f), glm::vec3(0.f), glm::vec3(0.f), glm::vec3(0.f)), singular(false)
+{
+}
+
+Simulation::Simulation(const SymParams& params, float tickLength) : Simulation()
+{
+	Start(params, tickLength);
+}
+
+void Simulation::Start(const SymParams& params, float tickLength)
+{
+	this->params = params;
+	this->tickLength = tickLength;
+	plan = planTrajectory(params);
+	baseTime = 0.f;
+	tick = 0;
+	Evaluate(plan.startP3);
+}
+
+uint64_t Simulation::Step(uint64_t count)
+{
+	uint64_t taken = 0;
+	while (taken < count && !IsFinished()) {
+		tick++;
+		Evaluate(joints.p3);
+		taken++;
+	}
+	return taken;
+}
+
+void Simulation::Seek(float time)
+{
+	baseTime = std::clamp(time, 0.f, 100.f / params.speed);
+	tick = 0;
+	Evaluate(joints.p3);
+}
+
+void Simulation::SetSpeed(float speed)
+{
+	if (speed <= 0.f)
+		return;
+	baseTime = GetTime() * params.speed / speed;
+	tick = 0;
+	params.speed = speed;
+}
+
+void Simulation::SetTickLength(float tickLength)
+{
+	// rebasing on an unchanged length would move the following ticks off the grid for nothing
+	if (tickLength == this->tickLength)
+		return;
+	Rebase();
+	this->tickLength = tickLength;
+}
+
+void Simulation::SetLengths(const glm::vec3& lengths)
+{
+	params.lengths = lengths;
+	plan = planTrajectory(params);
+	Evaluate(plan.startP3);
+}
+
+bool Simulation::IsFinished() const
+{
+	return GetTime() * params.speed / 100.f >= 1.f;
+}
+
+float Simulation::GetTime() const
+{
+	return baseTime + tick * tickLength;
+}
+
+float Simulation::GetParameter() const
+{
+	return std::min(GetTime() * params.speed / 100.f, 1.f);
+}
+
+void Simulation::Fill(SymData& data) const
+{
+	data.time = GetTime();
+	data.lengths = params.lengths;
+	calculateSymData(params, plan, GetParameter(), effectorFrame, joints, data);
+}
+
+void Simulation::Evaluate(const glm::vec3& prevP3)
+{
+	effectorFrame = interpolateFrames(params.startFrame, params.endFrame, GetParameter());
+	joints = calculateJoints(effectorFrame, params.lengths, &prevP3, &singular);
+}
+
+void Simulation::Rebase()
+{
+	baseTime = GetTime();
+	tick = 0;
+}
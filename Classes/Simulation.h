@@ -0,0 +1,74 @@
+#pragma once
+
+#include "simulator.h"
+#include <cstdint>
+
+// Fixed-step simulation of one trajectory, free of threads and clocks. The time is computed from an integer tick
+// count as baseTime + tick * tickLength instead of being summed up, so the same params and tick length give
+// bit-identical samples at any stepping speed and machine load. Seek, SetSpeed and SetTickLength start a new
+// segment from the current time, the ticks of a segment stay on its own grid.
+class Simulation
+{
+private:
+	SymParams params;
+	SymPlan plan;
+	float tickLength;
+	float baseTime;
+	uint64_t tick;
+
+	// state of the current tick
+	Transform effectorFrame;
+	Joints joints;
+	bool singular;
+
+	// recomputes the current tick, chaining the elbow solution from prevP3
+	void Evaluate(const glm::vec3& prevP3);
+	void Rebase();
+
+public:
+	Simulation();
+	Simulation(const SymParams& params, float tickLength);
+
+	// restarts at time 0 with the elbow solution of the start pose, params.speed must be positive
+	void Start(const SymParams& params, float tickLength);
+
+	// Advances up to count ticks and returns how many were taken, fewer once the end of the trajectory is reached.
+	// Every tick in between is evaluated, the elbow solution of each depends on the previous one.
+	uint64_t Step(uint64_t count = 1);
+
+	// Calls visit(*this) for the current tick and every following one up to the end, returns the number of calls
+	template <typename Visit>
+	uint64_t RunToCompletion(Visit visit)
+	{
+		uint64_t calls = 1;
+		visit(*this);
+		while (Step() > 0) {
+			visit(*this);
+			calls++;
+		}
+		return calls;
+	}
+
+	// time clamped to the trajectory, seeking back into a finished run lets it play again
+	void Seek(float time);
+	// keeps the trajectory parameter where it is, only the rate changes
+	void SetSpeed(float speed);
+	void SetTickLength(float tickLength);
+	// replans the trajectory and restarts the elbow chain at the current time
+	void SetLengths(const glm::vec3& lengths);
+
+	bool IsFinished() const;
+	// ticks taken since the start of the current segment
+	uint64_t GetTick() const { return tick; }
+	float GetTime() const;
+	// trajectory parameter in [0, 1]
+	float GetParameter() const;
+	const SymParams& GetParams() const { return params; }
+	const Transform& GetEffectorFrame() const { return effectorFrame; }
+	const Joints& GetJoints() const { return joints; }
+	// see calculateJoints
+	bool IsSingular() const { return singular; }
+
+	// fills everything but the stamp and epoch
+	void Fill(SymData& data) const;
+};
@@ -0,0 +1,232 @@
+#include "SimulationWorker.h"
+#include "TickScheduler.h"
+#include <algorithm>
+#include <fstream>
+
+SimulationWorker::SimulationWorker() :
+	terminate(false), running(false), paused(false), tickRate(defaultTickRate), spinThreshold(500),
+	hasTrajectory(false), epoch(0)
+{
+	thread = std::thread(&SimulationWorker::Run, this);
+}
+
+SimulationWorker::~SimulationWorker()
+{
+	terminate = true;
+	thread.join();
+}
+
+void SimulationWorker::Send(const SimCommand& command)
+{
+	// the worker drains the queue every tick, so it can only fill up for a moment
+	while (!commands.Push(command))
+		std::this_thread::yield();
+}
+
+void SimulationWorker::Start(const SymParams& params)
+{
+	SimCommand command(SimCommandType::Start);
+	command.params = params;
+	Send(command);
+}
+
+void SimulationWorker::Stop()
+{
+	Send(SimCommand(SimCommandType::Stop));
+}
+
+void SimulationWorker::Pause()
+{
+	Send(SimCommand(SimCommandType::Pause));
+}
+
+void SimulationWorker::Resume()
+{
+	Send(SimCommand(SimCommandType::Resume));
+}
+
+void SimulationWorker::Seek(float time)
+{
+	Send(SimCommand(SimCommandType::Seek, time));
+}
+
+void SimulationWorker::SetSpeed(float speed)
+{
+	Send(SimCommand(SimCommandType::SetSpeed, speed));
+}
+
+void SimulationWorker::SetLengths(const glm::vec3& lengths)
+{
+	SimCommand command(SimCommandType::SetLengths);
+	command.params.lengths = lengths;
+	Send(command);
+}
+
+void SimulationWorker::SetTickRate(int hz)
+{
+	if (hz > 0)
+		tickRate = hz;
+}
+
+void SimulationWorker::SetSpinThreshold(int microseconds)
+{
+	spinThreshold = microseconds;
+}
+
+void SimulationWorker::ResetStats()
+{
+	Send(SimCommand(SimCommandType::ResetStats));
+}
+
+bool SimulationWorker::IsRunning() const
+{
+	return running;
+}
+
+bool SimulationWorker::IsPaused() const
+{
+	return paused;
+}
+
+const TickStats& SimulationWorker::GetTickStats() const
+{
+	return stats;
+}
+
+bool SimulationWorker::Update()
+{
+	return buffer.Update();
+}
+
+const SymData& SimulationWorker::GetData() const
+{
+	return buffer.GetFront();
+}
+
+void SimulationWorker::Run()
+{
+	int rate = tickRate;
+	TickScheduler scheduler(std::chrono::nanoseconds(1000000000 / rate), std::chrono::microseconds(spinThreshold.load()));
+	SimCommand command;
+
+	while (!terminate) {
+		uint64_t appliedEpoch = epoch;
+		while (commands.Pop(command))
+			Apply(command);
+		// a jump waits a tick before stepping on, so its snapshot is not replaced before the renderer can take it
+		bool jumped = epoch != appliedEpoch;
+
+		if (rate != tickRate) {
+			rate = tickRate;
+			scheduler.SetPeriod(std::chrono::nanoseconds(1000000000 / rate));
+			simulation.SetTickLength(1.f / rate);
+		}
+
+		bool active = running && !paused;
+		if (active && !jumped) {
+			auto start = std::chrono::steady_clock::now();
+			Step();
+			stats.compute.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		}
+
+		// idle ticks only poll the queue, spinning for them would just burn a core
+		scheduler.SetSpinThreshold(std::chrono::microseconds(active ? spinThreshold.load() : 0));
+		std::chrono::nanoseconds overshoot = scheduler.WaitNext();
+		if (active) {
+			stats.overshoot.Record(overshoot.count());
+			stats.sleepDebt.Record(scheduler.GetDebt().count());
+		}
+	}
+}
+
+void SimulationWorker::Apply(const SimCommand& command)
+{
+	switch (command.type) {
+	case SimCommandType::Start:
+		simulation.Start(command.params, 1.f / tickRate);
+		hasTrajectory = true;
+		running = true;
+		paused = false;
+		Publish(false);
+		break;
+
+	case SimCommandType::Stop:
+		running = false;
+		paused = false;
+		break;
+
+	case SimCommandType::Pause:
+		paused = true;
+		break;
+
+	case SimCommandType::Resume:
+		paused = false;
+		break;
+
+	case SimCommandType::Seek:
+		if (!hasTrajectory)
+			break;
+		simulation.Seek(command.value);
+		// seeking back into a finished run lets it play again
+		running = !simulation.IsFinished();
+		Publish(false);
+		break;
+
+	case SimCommandType::SetSpeed:
+		simulation.SetSpeed(command.value);
+		break;
+
+	case SimCommandType::ResetStats:
+		stats.compute.Reset();
+		stats.overshoot.Reset();
+		stats.sleepDebt.Reset();
+		break;
+
+	case SimCommandType::SetLengths:
+		if (!hasTrajectory)
+			break;
+		simulation.SetLengths(command.params.lengths);
+		Publish(false);
+		break;
+	}
+}
+
+void SimulationWorker::Step()
+{
+	simulation.Step();
+	if (simulation.IsFinished())
+		running = false;
+	Publish(true);
+}
+
+void SimulationWorker::Publish(bool continuous)
+{
+	if (!continuous)
+		epoch++;
+
+	SymData& data = buffer.GetBack();
+	simulation.Fill(data);
+	data.stamp = std::chrono::steady_clock::now();
+	data.epoch = epoch;
+	buffer.Publish();
+}
+
+bool TickStats::WriteCsv(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+
+	file << "bucket_low_ns,bucket_high_ns,compute,overshoot,sleep_debt\n";
+	for (int i = 0; i < compute.GetBucketCount(); i++) {
+		uint64_t computeCount = compute.GetBucketCountAt(i);
+		uint64_t overshootCount = overshoot.GetBucketCountAt(i);
+		uint64_t debtCount = sleepDebt.GetBucketCountAt(i);
+		if (computeCount == 0 && overshootCount == 0 && debtCount == 0)
+			continue;
+
+		file << compute.GetBucketLow(i) << ',' << compute.GetBucketHigh(i) << ','
+			<< computeCount << ',' << overshootCount << ',' << debtCount << '\n';
+	}
+	return (bool)file;
+}
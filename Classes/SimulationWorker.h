@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Simulation.h"
+#include "SPSCQueue.h"
+#include "TripleBuffer.h"
+#include "Histogram.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+enum class SimCommandType {
+	Start,
+	Stop,
+	Pause,
+	Resume,
+	Seek,
+	SetSpeed,
+	SetLengths,
+	ResetStats
+};
+
+struct SimCommand {
+	SimCommandType type;
+	// Start: the whole trajectory, SetLengths: only params.lengths is read
+	SymParams params;
+	// Seek: time in seconds, SetSpeed: the new speed
+	float value;
+
+	SimCommand() : type(SimCommandType::Stop), value(0.f) {}
+	SimCommand(SimCommandType type, float value = 0.f) : type(type), value(value) {}
+};
+
+// Timings of the ticks that advanced the simulation, in nanoseconds
+struct TickStats {
+	// time spent computing the tick
+	Histogram compute;
+	// how late the scheduler woke up after the deadline
+	Histogram overshoot;
+	// how far behind schedule the tick already was when it finished computing
+	Histogram sleepDebt;
+
+	// one row per histogram bucket that holds any value
+	bool WriteCsv(const std::string& path) const;
+};
+
+// Long-lived simulation thread controlled over a lock-free command queue. The thread, its plan and the snapshot
+// buffers live as long as the worker, so starting another run only costs one queue push from the UI thread.
+class SimulationWorker
+{
+private:
+	SPSCQueue<SimCommand, 64> commands;
+	TripleBuffer<SymData> buffer;
+	std::atomic<bool> terminate;
+	std::atomic<bool> running;
+	std::atomic<bool> paused;
+	std::atomic<int> tickRate;			// in Hz
+	std::atomic<int> spinThreshold;		// in microseconds
+	TickStats stats;
+
+	// owned by the worker thread
+	bool hasTrajectory;
+	Simulation simulation;
+	uint64_t epoch;
+
+	std::thread thread;
+
+	void Send(const SimCommand& command);
+	void Run();
+	void Apply(const SimCommand& command);
+	void Step();
+	// continuous is false for jumps the renderer must not blend across, they start a new epoch
+	void Publish(bool continuous);
+
+public:
+	SimulationWorker();
+	~SimulationWorker();
+
+	SimulationWorker(const SimulationWorker&) = delete;
+	SimulationWorker& operator=(const SimulationWorker&) = delete;
+
+	// UI thread side, commands are applied at the start of the next tick
+	void Start(const SymParams& params);
+	void Stop();
+	void Pause();
+	void Resume();
+	void Seek(float time);
+	void SetSpeed(float speed);
+	void SetLengths(const glm::vec3& lengths);
+	void SetTickRate(int hz);
+	void SetSpinThreshold(int microseconds);
+	void ResetStats();
+
+	bool IsRunning() const;
+	bool IsPaused() const;
+	const TickStats& GetTickStats() const;
+
+	// takes the newest published snapshot, returns true when it changed
+	bool Update();
+	const SymData& GetData() const;
+};
@@ -0,0 +1,96 @@
+#include "TickScheduler.h"
+#include <algorithm>
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#elif defined(__linux__)
+#include <time.h>
+#include <cerrno>
+#endif
+
+TickScheduler::TickScheduler(std::chrono::nanoseconds period, std::chrono::nanoseconds spinThreshold)
+	: deadline(std::chrono::steady_clock::now()), period(period), spinThreshold(spinThreshold), debt(0), timer(nullptr)
+{
+#if defined(_WIN32)
+	// high resolution timers exist since Windows 10 1803, older systems get the regular one
+	timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (timer == NULL)
+		timer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+#endif
+}
+
+TickScheduler::~TickScheduler()
+{
+#if defined(_WIN32)
+	if (timer != NULL)
+		CloseHandle(timer);
+#endif
+}
+
+void TickScheduler::SetPeriod(std::chrono::nanoseconds period)
+{
+	this->period = period;
+}
+
+void TickScheduler::SetSpinThreshold(std::chrono::nanoseconds spinThreshold)
+{
+	this->spinThreshold = spinThreshold;
+}
+
+void TickScheduler::SleepUntil(std::chrono::steady_clock::time_point wakeUp)
+{
+	auto remaining = wakeUp - std::chrono::steady_clock::now();
+	if (remaining <= std::chrono::nanoseconds::zero())
+		return;
+
+#if defined(_WIN32)
+	if (timer != NULL) {
+		// relative due time in 100 ns units
+		LARGE_INTEGER dueTime;
+		dueTime.QuadPart = -(LONGLONG)(std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count() / 100);
+		if (SetWaitableTimer(timer, &dueTime, 0, NULL, NULL, FALSE)) {
+			WaitForSingleObject(timer, INFINITE);
+			return;
+		}
+	}
+	std::this_thread::sleep_until(wakeUp);
+#elif defined(__linux__)
+	// steady_clock is CLOCK_MONOTONIC on Linux
+	auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(wakeUp.time_since_epoch()).count();
+	timespec target;
+	target.tv_sec = (time_t)(sinceEpoch / 1000000000);
+	target.tv_nsec = (long)(sinceEpoch % 1000000000);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {}
+#else
+	std::this_thread::sleep_until(wakeUp);
+#endif
+}
+
+std::chrono::nanoseconds TickScheduler::WaitNext()
+{
+	deadline += period;
+
+	// after a long stall (debugger, suspended process) restart from now instead of bursting through missed ticks
+	auto now = std::chrono::steady_clock::now();
+	debt = std::max(std::chrono::nanoseconds::zero(), std::chrono::nanoseconds(now - deadline));
+	if (now - deadline > period)
+		deadline = now;
+
+	SleepUntil(deadline - spinThreshold);
+	while (std::chrono::steady_clock::now() < deadline) {
+		// the last stretch is spun, OS wake-ups are too coarse for it
+	}
+
+	return std::chrono::steady_clock::now() - deadline;
+}
+
+std::chrono::nanoseconds TickScheduler::GetDebt() const
+{
+	return debt;
+}
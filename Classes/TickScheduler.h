@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+
+// Paces a fixed-rate loop on absolute deadlines. The thread sleeps in the OS until spinThreshold before
+// the deadline and spins for the rest, so lateness never accumulates and the CPU stays mostly idle.
+class TickScheduler
+{
+private:
+	std::chrono::steady_clock::time_point deadline;
+	std::chrono::nanoseconds period;
+	std::chrono::nanoseconds spinThreshold;
+	// how far past its deadline the last tick already was when it asked to wait
+	std::chrono::nanoseconds debt;
+	// waitable timer handle on Windows
+	void* timer;
+
+	void SleepUntil(std::chrono::steady_clock::time_point wakeUp);
+
+public:
+	TickScheduler(std::chrono::nanoseconds period, std::chrono::nanoseconds spinThreshold);
+	~TickScheduler();
+
+	TickScheduler(const TickScheduler&) = delete;
+	TickScheduler& operator=(const TickScheduler&) = delete;
+
+	void SetPeriod(std::chrono::nanoseconds period);
+	void SetSpinThreshold(std::chrono::nanoseconds spinThreshold);
+
+	// blocks until the next deadline and returns how late it woke up
+	std::chrono::nanoseconds WaitNext();
+	std::chrono::nanoseconds GetDebt() const;
+};
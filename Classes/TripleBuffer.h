@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+// Single-producer single-consumer triple buffer. The producer fills the back slot and publishes it with one
+// atomic exchange, the consumer swaps in the newest published slot. Neither side ever waits for the other.
+template <typename T>
+class TripleBuffer
+{
+private:
+	// the middle index carries a flag telling whether it holds a snapshot the consumer has not taken yet
+	static constexpr int freshFlag = 4;
+	static constexpr int indexMask = 3;
+
+	std::array<T, 3> slots;
+	alignas(64) std::atomic<int> middle;
+	alignas(64) int back;
+	alignas(64) int front;
+
+public:
+	TripleBuffer() : slots(), middle(1), back(0), front(2) {}
+
+	// producer side, every field of the back slot has to be rewritten before Publish
+	T& GetBack() { return slots[back]; }
+
+	void Publish() {
+		back = middle.exchange(back | freshFlag, std::memory_order_acq_rel) & indexMask;
+	}
+
+	// consumer side, returns true when a newer snapshot was taken
+	bool Update() {
+		if ((middle.load(std::memory_order_relaxed) & freshFlag) == 0)
+			return false;
+
+		front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+		return true;
+	}
+
+	const T& GetFront() const { return slots[front]; }
+};
@@ -0,0 +1,51 @@
+#include "UBO.h"
+#include <cstring>
+
+UBO::UBO(GLsizeiptr size, GLuint binding, int slotCount)
+	: size(size), binding(binding), slotCount(slotCount), slot(0), fences(slotCount, nullptr)
+{
+	// glBindBufferRange offsets have to respect the driver's alignment
+	GLint alignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	stride = (size + alignment - 1) / alignment * alignment;
+
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glGenBuffers(1, &ID);
+	glBindBuffer(GL_UNIFORM_BUFFER, ID);
+	glBufferStorage(GL_UNIFORM_BUFFER, stride * slotCount, nullptr, flags);
+	mapped = (char*)glMapBufferRange(GL_UNIFORM_BUFFER, 0, stride * slotCount, flags);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UBO::Write(const void* data)
+{
+	slot = (slot + 1) % slotCount;
+
+	if (fences[slot] != nullptr) {
+		while (glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+		glDeleteSync(fences[slot]);
+		fences[slot] = nullptr;
+	}
+
+	memcpy(mapped + stride * slot, data, size);
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding, ID, stride * slot, size);
+}
+
+void UBO::Fence()
+{
+	if (fences[slot] != nullptr)
+		glDeleteSync(fences[slot]);
+	fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void UBO::Delete()
+{
+	for (GLsync fence : fences) {
+		if (fence != nullptr)
+			glDeleteSync(fence);
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, ID);
+	glUnmapBuffer(GL_UNIFORM_BUFFER);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glDeleteBuffers(1, &ID);
+}
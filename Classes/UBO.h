@@ -0,0 +1,30 @@
+#ifndef UBO_CLASS_H
+#define UBO_CLASS_H
+
+#include "glad/glad.h"
+#include <vector>
+
+// Uniform buffer written once per frame through a persistent mapping. The storage is split into slotCount slots
+// used round-robin, each guarded by a fence, so the CPU never overwrites data a frame in flight still reads.
+class UBO
+{
+public:
+	GLuint ID;
+	UBO(GLsizeiptr size, GLuint binding, int slotCount = 3);
+
+	// waits until the GPU has released the next slot, copies size bytes into it and binds it to the binding point
+	void Write(const void* data);
+	// call after the frame's draws, the current slot stays reserved until they complete
+	void Fence();
+	void Delete();
+
+private:
+	GLsizeiptr size;
+	GLsizeiptr stride;
+	GLuint binding;
+	int slotCount;
+	int slot;
+	char* mapped;
+	std::vector<GLsync> fences;
+};
+#endif
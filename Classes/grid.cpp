@@ -5,22 +5,27 @@ Grid::Grid(float sizeN, int divisionN)
     : Figure(InitializeAndCalculate(sizeN, divisionN)){};
 
 void Grid::Render(int colorLoc)
+{
+  RenderInstanced(colorLoc, 1);
+}
+
+void Grid::RenderInstanced(int colorLoc, GLsizei instanceCount)
 {
   vao.Bind();
 
   // main grid
   glLineWidth(1.0f);
   glUniform4fv(colorLoc, 1, glm::value_ptr(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f)));
-  glDrawElements(GL_LINES, indices_count - 4 * division, GL_UNSIGNED_INT, 0);
+  glDrawElementsInstanced(GL_LINES, indices_count - 4 * division, GL_UNSIGNED_INT, 0, instanceCount);
   // X axis
   glLineWidth(3.0f);
   glUniform4fv(colorLoc, 1, glm::value_ptr(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f)));
-  glDrawElements(GL_LINES, 2 * division, GL_UNSIGNED_INT,
-                 (void *)((indices_count - 4 * division) * sizeof(GLuint)));
+  glDrawElementsInstanced(GL_LINES, 2 * division, GL_UNSIGNED_INT,
+                 (void *)((indices_count - 4 * division) * sizeof(GLuint)), instanceCount);
   // Y axis
   glUniform4fv(colorLoc, 1, glm::value_ptr(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)));
-  glDrawElements(GL_LINES, 2 * division, GL_UNSIGNED_INT,
-                 (void *)((indices_count - 2 * division) * sizeof(GLuint)));
+  glDrawElementsInstanced(GL_LINES, 2 * division, GL_UNSIGNED_INT,
+                 (void *)((indices_count - 2 * division) * sizeof(GLuint)), instanceCount);
 
   vao.Unbind();
 }
@@ -10,6 +10,8 @@ public:
   Grid(float sizeN = 300.f, int divisionN = 100);
 
   void Render(int colorLoc) override;
+  // instance i is sent to viewport i when the shader supports gl_ViewportIndex
+  void RenderInstanced(int colorLoc, GLsizei instanceCount);
 
 private:
   std::tuple<std::vector<GLfloat>, std::vector<GLuint>> Calculate() const;
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Splits [0, count) into one contiguous chunk per hardware thread and runs body(begin, end) on each.
+// The calling thread takes the first chunk and returns once all chunks are done.
+template <typename Body>
+void parallelFor(size_t count, Body body, size_t minChunk = 1)
+{
+	size_t threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = std::min(threads, (count + minChunk - 1) / minChunk);
+	if (threads <= 1) {
+		if (count > 0)
+			body(size_t(0), count);
+		return;
+	}
+
+	size_t chunk = (count + threads - 1) / threads;
+	std::vector<std::thread> workers;
+	for (size_t begin = chunk; begin < count; begin += chunk) {
+		workers.emplace_back(body, begin, std::min(count, begin + chunk));
+	}
+	body(size_t(0), chunk);
+
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
@@ -0,0 +1,175 @@
+#define _USE_MATH_DEFINES
+#include "trajectory.h"
+#include "parallel.h"
+#include <cstring>
+
+BakedTrajectory::BakedTrajectory(const SymParams& params, float tickLength)
+	: tickLength(tickLength), duration(100.f / params.speed), lengths(params.lengths)
+{
+	samples.resize((size_t)std::ceil(duration / tickLength) + 1);
+
+	auto parameterAt = [&](size_t tick) {
+		return std::min(tick * tickLength * params.speed / 100.f, 1.f);
+	};
+
+	SymPlan plan = planTrajectory(params);
+
+	// the elbow solution depends on the previous tick, so joint positions are chained sequentially
+	std::vector<Transform> effectorFrames(samples.size());
+	std::vector<Joints> joints;
+	joints.reserve(samples.size());
+
+	glm::vec3 prevP3 = plan.startP3;
+	for (size_t i = 0; i < samples.size(); i++) {
+		effectorFrames[i] = interpolateFrames(params.startFrame, params.endFrame, parameterAt(i));
+		joints.push_back(calculateJoints(effectorFrames[i], lengths, &prevP3));
+		prevP3 = joints.back().p3;
+	}
+
+	// everything else is independent per tick
+	parallelFor(samples.size(), [&](size_t begin, size_t end) {
+		SymData data;
+		for (size_t i = begin; i < end; i++) {
+			calculateSymData(params, plan, parameterAt(i), effectorFrames[i], joints[i], data);
+			samples[i].leftModels = data.leftModels;
+			samples[i].rightModels = data.rightModels;
+			samples[i].q2s = data.q2s;
+		}
+	}, 256);
+}
+
+float BakedTrajectory::GetDuration() const
+{
+	return duration;
+}
+
+size_t BakedTrajectory::GetSampleCount() const
+{
+	return samples.size();
+}
+
+size_t BakedTrajectory::GetByteSize() const
+{
+	return samples.size() * sizeof(BakedSample);
+}
+
+void BakedTrajectory::Sample(float time, SymData& data) const
+{
+	float position = glm::clamp(time / tickLength, 0.f, (float)(samples.size() - 1));
+	size_t index = (size_t)position;
+	float fraction = position - index;
+
+	const BakedSample& sample = samples[index];
+	data.time = time;
+	data.lengths = lengths;
+
+	if (fraction <= 0.f || index + 1 >= samples.size()) {
+		data.leftModels = sample.leftModels;
+		data.rightModels = sample.rightModels;
+		data.q2s = sample.q2s;
+		return;
+	}
+
+	const BakedSample& next = samples[index + 1];
+	for (int i = 0; i < 5; i++) {
+		data.leftModels[i] = interpolateModels(sample.leftModels[i], next.leftModels[i], fraction);
+		data.rightModels[i] = interpolateModels(sample.rightModels[i], next.rightModels[i], fraction);
+	}
+	for (int i = 0; i < 2; i++) {
+		data.q2s[i] = glm::mix(sample.q2s[i], next.q2s[i], fraction);
+	}
+}
+
+// every float that determines a baked trajectory, in a fixed order
+using CacheKey = std::array<float, 19>;
+
+static CacheKey keyValues(const SymParams& params, float tickLength)
+{
+	glm::vec3 startOrigin = params.startFrame.GetOrigin();
+	glm::quat startRotation = params.startFrame.GetRotation();
+	glm::vec3 endOrigin = params.endFrame.GetOrigin();
+	glm::quat endRotation = params.endFrame.GetRotation();
+
+	return {
+		startOrigin.x, startOrigin.y, startOrigin.z,
+		startRotation.w, startRotation.x, startRotation.y, startRotation.z,
+		endOrigin.x, endOrigin.y, endOrigin.z,
+		endRotation.w, endRotation.x, endRotation.y, endRotation.z,
+		params.lengths.x, params.lengths.y, params.lengths.z,
+		params.speed, tickLength
+	};
+}
+
+// FNV-1a over the bit patterns of the key values
+static size_t hashKey(const CacheKey& values)
+{
+	uint64_t hash = 14695981039346656037ull;
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(values.data());
+	for (size_t i = 0; i < sizeof(values); i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return (size_t)hash;
+}
+
+TrajectoryCache::TrajectoryCache(size_t maxBytes)
+	: maxBytes(maxBytes), usedBytes(0) {}
+
+std::shared_ptr<const BakedTrajectory> TrajectoryCache::Find(const SymParams& params, float tickLength)
+{
+	CacheKey key = keyValues(params, tickLength);
+	auto found = lookup.find(hashKey(key));
+	if (found == lookup.end())
+		return nullptr;
+
+	// a hash collision is treated as a miss
+	CacheKey entryKey = keyValues(found->second->params, found->second->tickLength);
+	if (std::memcmp(key.data(), entryKey.data(), sizeof(key)) != 0)
+		return nullptr;
+
+	entries.splice(entries.begin(), entries, found->second);
+	return found->second->trajectory;
+}
+
+std::shared_ptr<const BakedTrajectory> TrajectoryCache::GetOrBake(const SymParams& params, float tickLength)
+{
+	std::shared_ptr<const BakedTrajectory> trajectory = Find(params, tickLength);
+	if (trajectory)
+		return trajectory;
+
+	trajectory = std::make_shared<const BakedTrajectory>(params, tickLength);
+	size_t hash = hashKey(keyValues(params, tickLength));
+
+	auto found = lookup.find(hash);
+	if (found != lookup.end()) {
+		usedBytes -= found->second->trajectory->GetByteSize();
+		entries.erase(found->second);
+	}
+
+	entries.push_front({ hash, params, tickLength, trajectory });
+	lookup[hash] = entries.begin();
+	usedBytes += trajectory->GetByteSize();
+	Evict();
+
+	return trajectory;
+}
+
+void TrajectoryCache::Evict()
+{
+	// the newest entry always stays, even when it alone exceeds the budget
+	while (usedBytes > maxBytes && entries.size() > 1) {
+		usedBytes -= entries.back().trajectory->GetByteSize();
+		lookup.erase(entries.back().hash);
+		entries.pop_back();
+	}
+}
+
+size_t TrajectoryCache::GetEntryCount() const
+{
+	return entries.size();
+}
+
+size_t TrajectoryCache::GetByteSize() const
+{
+	return usedBytes;
+}
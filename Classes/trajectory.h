@@ -0,0 +1,66 @@
+#pragma once
+
+#include "simulator.h"
+#include <vector>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+struct BakedSample {
+	std::array<glm::mat4, 5> leftModels;
+	std::array<glm::mat4, 5> rightModels;
+	std::array<float, 2> q2s;
+};
+
+// Whole start->end trajectory computed up front, one sample per simulation tick
+class BakedTrajectory
+{
+private:
+	float tickLength;
+	float duration;
+	glm::vec3 lengths;
+	std::vector<BakedSample> samples;
+
+public:
+	// tickLength in seconds
+	BakedTrajectory(const SymParams& params, float tickLength);
+
+	// seconds until the effector reaches the end pose
+	float GetDuration() const;
+	size_t GetSampleCount() const;
+	size_t GetByteSize() const;
+
+	// state at the given playback time, blended between the neighbouring ticks
+	void Sample(float time, SymData& data) const;
+};
+
+// Bounded LRU of baked trajectories keyed by the simulation parameters and tick length.
+// Entries are evicted least recently used first once their total size exceeds the budget.
+class TrajectoryCache
+{
+private:
+	struct Entry {
+		size_t hash;
+		SymParams params;
+		float tickLength;
+		std::shared_ptr<const BakedTrajectory> trajectory;
+	};
+
+	size_t maxBytes;
+	size_t usedBytes;
+	// most recently used first
+	std::list<Entry> entries;
+	std::unordered_map<size_t, std::list<Entry>::iterator> lookup;
+
+	void Evict();
+
+public:
+	TrajectoryCache(size_t maxBytes = 256 * 1024 * 1024);
+
+	// nullptr on a miss
+	std::shared_ptr<const BakedTrajectory> Find(const SymParams& params, float tickLength);
+	std::shared_ptr<const BakedTrajectory> GetOrBake(const SymParams& params, float tickLength);
+
+	size_t GetEntryCount() const;
+	size_t GetByteSize() const;
+};
@@ -0,0 +1,73 @@
+#include "Transform.h"
+#include "Frame.h"
+
+Transform::Transform()
+{
+	this->rotation = glm::quat(1.f, 0.f, 0.f, 0.f);
+	this->translation = glm::vec3(0.f);
+}
+
+Transform::Transform(glm::vec3 translation, glm::quat rotation)
+{
+	this->rotation = rotation;
+	this->translation = translation;
+}
+
+Transform::Transform(const Frame& frame)
+{
+	this->rotation = frame.GetRotation();
+	this->translation = frame.GetOrigin();
+}
+
+glm::vec3 Transform::GetX() const
+{
+	return rotation * glm::vec3(1.f, 0.f, 0.f);
+}
+
+glm::vec3 Transform::GetY() const
+{
+	return rotation * glm::vec3(0.f, 1.f, 0.f);
+}
+
+glm::vec3 Transform::GetZ() const
+{
+	return rotation * glm::vec3(0.f, 0.f, 1.f);
+}
+
+glm::vec3 Transform::GetOrigin() const
+{
+	return translation;
+}
+
+glm::quat Transform::GetRotation() const
+{
+	return rotation;
+}
+
+Transform Transform::operator*(const Transform& other) const
+{
+	return Transform(translation + rotation * other.translation, rotation * other.rotation);
+}
+
+Transform Transform::Inverse() const
+{
+	glm::quat inverseRotation = glm::conjugate(rotation);
+	return Transform(inverseRotation * -translation, inverseRotation);
+}
+
+glm::vec3 Transform::TransformPoint(glm::vec3 point) const
+{
+	return translation + rotation * point;
+}
+
+glm::vec3 Transform::TransformVector(glm::vec3 vector) const
+{
+	return rotation * vector;
+}
+
+glm::mat4 Transform::GetMatrix() const
+{
+	glm::mat4 matrix = glm::mat4_cast(rotation);
+	matrix[3] = glm::vec4(translation, 1.f);
+	return matrix;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "glm/glm.hpp"
+#include <glm/gtc/quaternion.hpp>
+
+class Frame;
+
+// Rigid transform kept as a unit quaternion and a translation.
+// Composition and matrix emission never go through a 3x3 matrix, unlike Frame.
+class Transform
+{
+private:
+	glm::quat rotation;
+	glm::vec3 translation;
+
+public:
+	Transform();
+	Transform(glm::vec3 translation, glm::quat rotation);
+	Transform(const Frame& frame);
+
+	glm::vec3 GetX() const;
+	glm::vec3 GetY() const;
+	glm::vec3 GetZ() const;
+	glm::vec3 GetOrigin() const;
+	glm::quat GetRotation() const;
+
+	// other is expressed in the local coordinates of this transform
+	Transform operator*(const Transform& other) const;
+	Transform Inverse() const;
+	glm::vec3 TransformPoint(glm::vec3 point) const;
+	glm::vec3 TransformVector(glm::vec3 vector) const;
+	glm::mat4 GetMatrix() const;
+};
@@ -0,0 +1,157 @@
+#define _USE_MATH_DEFINES
+#include "kinematics.h"
+#include <cmath>
+
+float normalizeAngle(const float angle) {
+	float newAngle = angle;
+	while (newAngle > M_PI) {
+		newAngle -= 2 * M_PI;
+	}
+	while (newAngle < -M_PI) {
+		newAngle += 2 * M_PI;
+	}
+	return newAngle;
+}
+
+bool isVec3NaN(const glm::vec3& vec) {
+	return std::isnan(vec.x) || std::isnan(vec.y) || std::isnan(vec.z);
+}
+
+Joints calculateJoints(const Transform& effectorFrame, const glm::vec3& lengths, const glm::vec3* prevP3,
+	bool* singular)
+{
+	glm::vec3 p0 = baseFrame.GetOrigin();
+	glm::vec3 p1 = p0;
+	glm::vec3 p2 = p1 + baseFrame.GetZ() * lengths.x;
+
+	glm::vec3 p5 = effectorFrame.GetOrigin();
+	glm::vec3 p4 = p5 - effectorFrame.GetX() * lengths.z;
+
+	glm::vec3 v40 = glm::normalize(p4 - p0);
+	glm::vec3 v20 = glm::normalize(p2 - p0);
+	glm::vec3 normCross = glm::cross(v40, v20);
+	glm::vec3 norm = glm::normalize(normCross);
+	glm::vec3 v34Cross = glm::cross(norm, effectorFrame.GetX());
+	glm::vec3 v34n = glm::normalize(v34Cross);
+	if (singular != nullptr)
+		*singular = !(glm::length(normCross) > singularityEpsilon) || !(glm::length(v34Cross) > singularityEpsilon);
+
+	glm::vec3 p3 = p4 + v34n * lengths.y;
+	if (prevP3 != nullptr) {
+		// set p3 to the closest point to the previous p3
+
+		glm::vec3 p3alt = p4 - v34n * lengths.y;
+
+		float distanceToPrev = glm::distance(p3, *prevP3);
+		float altDistanceToPrev = glm::distance(p3alt, *prevP3);
+		if (altDistanceToPrev < distanceToPrev)
+			p3 = p3alt;
+	}
+	if (isVec3NaN(p3)) {
+		// case when v34 and x5 are parallel
+
+		if (prevP3 != nullptr) {
+			float distance = glm::dot(*prevP3, norm);
+			p3 = *prevP3 - norm * distance;
+		}
+		else {
+			glm::vec3 v24 = glm::normalize(p2 - p4);
+			p3 = p4 + v24 * lengths.y;
+		}
+	}
+	if (isVec3NaN(norm)) {
+		// case when v40 and v20 are parallel
+
+		glm::vec3 v24 = glm::normalize(p2 - p4);
+		p3 = p4 + v24 * lengths.y;
+	}
+
+	return Joints(p1, p2, p3, p4, p5);
+}
+
+IKSet solveConfiguration(const Transform& effectorFrame, const glm::vec3& lengths, const Joints& joints)
+{
+	glm::vec3 p0 = baseFrame.GetOrigin();
+	glm::vec3 p2 = joints.p2;
+	glm::vec3 p3 = joints.p3;
+	glm::vec3 p4 = joints.p4;
+
+	// calculate configuration space
+	float q2 = glm::distance(p2, p3);
+
+	// alpha1
+	glm::vec3 v40 = p4 - p0;
+	float alpha1 = atan2(glm::dot(v40, baseFrame.GetY()), glm::dot(v40, baseFrame.GetX()));
+
+	alpha1 = normalizeAngle(alpha1);
+	Transform F1 = baseFrame * Transform(glm::vec3(0.f), glm::angleAxis(alpha1, unitZ));
+
+	// alpha2
+	glm::vec3 v32 = p3 - p2;
+	float alpha2 = -atan2(glm::dot(v32, F1.GetZ()), glm::dot(v32, F1.GetX()));
+
+	alpha2 = normalizeAngle(alpha2);
+	Transform F2 = F1 * Transform(unitZ * lengths.x, glm::angleAxis(alpha2, unitY));
+
+	// alpha3
+	glm::vec3 v34 = p3 - p4;
+	glm::vec3 x3 = glm::cross(F2.GetY(), glm::normalize(v34));
+	float alpha3 = -atan2(glm::dot(x3, F2.GetZ()), glm::dot(x3, F2.GetX()));
+
+	alpha3 = normalizeAngle(alpha3);
+	Transform F3 = F2 * Transform(unitX * q2, glm::angleAxis(alpha3, unitY));
+
+	// alpha4
+	float alpha4 = atan2(glm::dot(effectorFrame.GetX(), F3.GetY()), glm::dot(effectorFrame.GetX(), F3.GetX()));
+
+	alpha4 = normalizeAngle(alpha4);
+	Transform F4 = F3 * Transform(unitZ * -lengths.y, glm::angleAxis(alpha4, unitZ));
+
+	// alpha5
+	glm::vec3 y4 = glm::cross(effectorFrame.GetX(), v34);
+	float alpha5 = M_PI_2 - atan2(glm::dot(effectorFrame.GetZ(), v34), glm::dot(effectorFrame.GetZ(), y4));
+
+	alpha5 = normalizeAngle(alpha5);
+	Transform F5 = F4 * Transform(unitX * lengths.z, glm::angleAxis(alpha5, unitX));
+
+	return IKSet(
+		joints, 
+		ConfigurationSpace(alpha1, alpha2, q2, alpha3, alpha4, alpha5), 
+		{ F1, F2, F3, F4, F5 });
+}
+
+IKSet solveInverseKinematics(const Transform& effectorFrame, const glm::vec3& lengths, const IKSet* prevIKData)
+{
+	const glm::vec3* prevP3 = prevIKData != nullptr ? &prevIKData->joints.p3 : nullptr;
+	return solveConfiguration(effectorFrame, lengths, calculateJoints(effectorFrame, lengths, prevP3));
+}
+
+std::array<Transform, 5> calculateFramesFromConfSpace(ConfigurationSpace configSpace, glm::vec3 lengths)
+{
+	Transform F1 = baseFrame * Transform(glm::vec3(0.f), glm::angleAxis(configSpace.alpha1, unitZ));
+	Transform F2 = F1 * Transform(unitZ * lengths.x, glm::angleAxis(configSpace.alpha2, unitY));
+	Transform F3 = F2 * Transform(unitX * configSpace.q2, glm::angleAxis(configSpace.alpha3, unitY));
+	Transform F4 = F3 * Transform(unitZ * -lengths.y, glm::angleAxis(configSpace.alpha4, unitZ));
+	Transform F5 = F4 * Transform(unitX * lengths.z, glm::angleAxis(configSpace.alpha5, unitX));
+
+	return { F1, F2, F3, F4, F5 };
+}
+
+Transform interpolateFrames(const Transform& startFrame, const Transform& endFrame, const float t)
+{
+	glm::vec3 posLerp = glm::mix(startFrame.GetOrigin(), endFrame.GetOrigin(), t);
+	glm::quat angleSlerp = glm::slerp(startFrame.GetRotation(), endFrame.GetRotation(), t);
+	return Transform(posLerp, angleSlerp);
+}
+
+ConfigurationSpace calculateIterpolationDirection(const ConfigurationSpace& startCS, const ConfigurationSpace& endCS)
+{
+	float angle1 = normalizeAngle(endCS.alpha1 - startCS.alpha1);
+	float angle2 = normalizeAngle(endCS.alpha2 - startCS.alpha2);
+	float q2 = endCS.q2 - startCS.q2;
+	float angle3 = normalizeAngle(endCS.alpha3 - startCS.alpha3);
+	float angle4 = normalizeAngle(endCS.alpha4 - startCS.alpha4);
+	float angle5 = normalizeAngle(endCS.alpha5 - startCS.alpha5);
+
+	return ConfigurationSpace(angle1, angle2, q2, angle3, angle4, angle5);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+#include <glm/gtx/quaternion.hpp>
+#include <Frame.h>
+#include <Transform.h>
+#include <array>
+#include <iostream>
+
+// cross products shorter than this count as parallel axes when reporting singular poses
+const float singularityEpsilon = 1e-4f;
+const Transform baseFrame = Transform();
+const glm::vec3 unitX = glm::vec3(1.f, 0.f, 0.f);
+const glm::vec3 unitY = glm::vec3(0.f, 1.f, 0.f);
+const glm::vec3 unitZ = glm::vec3(0.f, 0.f, 1.f);
+
+struct ConfigurationSpace {
+	float alpha1;
+	float alpha2;
+	float q2;
+	float alpha3;
+	float alpha4;
+	float alpha5;
+
+	ConfigurationSpace() :
+		alpha1(0.f), alpha2(0.f), q2(0.f), alpha3(0.f), alpha4(0.f), alpha5(0.f) {}
+
+	ConfigurationSpace(float alpha1, float alpha2, float q2, float alpha3, float alpha4, float alpha5) :
+		alpha1(alpha1), alpha2(alpha2), q2(q2), alpha3(alpha3), alpha4(alpha4), alpha5(alpha5) {}
+
+	ConfigurationSpace operator+(const ConfigurationSpace& other) const {
+		return ConfigurationSpace(
+			alpha1 + other.alpha1,
+			alpha2 + other.alpha2,
+			q2 + other.q2,
+			alpha3 + other.alpha3,
+			alpha4 + other.alpha4,
+			alpha5 + other.alpha5);
+	}
+
+	ConfigurationSpace operator*(const float& scalar) const {
+		return ConfigurationSpace(
+			alpha1 * scalar,
+			alpha2 * scalar,
+			q2 * scalar,
+			alpha3 * scalar,
+			alpha4 * scalar,
+			alpha5 * scalar);
+	}
+
+	void Print() {
+		std::cout << "alpha1: " << alpha1 << std::endl;
+		std::cout << "alpha2: " << alpha2 << std::endl;
+		std::cout << "q2: " << q2 << std::endl;
+		std::cout << "alpha3: " << alpha3 << std::endl;
+		std::cout << "alpha4: " << alpha4 << std::endl;
+		std::cout << "alpha5: " << alpha5 << std::endl;
+		std::cout << std::endl;
+	}
+};
+
+struct Joints {
+	glm::vec3 p1;
+	glm::vec3 p2;
+	glm::vec3 p3;
+	glm::vec3 p4;
+	glm::vec3 p5;
+
+	Joints(glm::vec3 p1, glm::vec3 p2, glm::vec3 p3, glm::vec3 p4, glm::vec3 p5) :
+		p1(p1), p2(p2), p3(p3), p4(p4), p5(p5) {}
+};
+
+struct IKSet {
+	Joints joints;
+	ConfigurationSpace configSpace;
+	std::array<Transform,5> frames;
+
+	IKSet(Joints joints, ConfigurationSpace configSpace, std::array<Transform, 5> frames) :
+		joints(joints), configSpace(configSpace), frames(frames) {}
+};
+
+// Wraps the angle to [-pi, pi]
+float normalizeAngle(const float angle);
+
+bool isVec3NaN(const glm::vec3& vec);
+
+// Joint positions for the effector pose. prevP3 (optional) picks the elbow solution closest to the previous one.
+// singular (optional) is set when the wrist centre lies on the base axis or the forearm is parallel to the effector
+// X axis, there the elbow is picked by a fallback and the joint angles can jump.
+Joints calculateJoints(const Transform& effectorFrame, const glm::vec3& lengths, const glm::vec3* prevP3,
+	bool* singular = nullptr);
+
+// Configuration space and link frames for the effector pose with already known joint positions
+IKSet solveConfiguration(const Transform& effectorFrame, const glm::vec3& lengths, const Joints& joints);
+
+IKSet solveInverseKinematics(const Transform& effectorFrame, const glm::vec3& lengths, const IKSet* prevIKData);
+
+// Link frames F1..F5 for the configuration, the forward kinematics counterpart of solveConfiguration
+std::array<Transform, 5> calculateFramesFromConfSpace(ConfigurationSpace configSpace, glm::vec3 lengths);
+
+// Effector pose at parameter t, lerping the origin and slerping the rotation
+Transform interpolateFrames(const Transform& startFrame, const Transform& endFrame, const float t);
+
+// Per joint difference between the configurations, angles taken the shorter way around
+ConfigurationSpace calculateIterpolationDirection(const ConfigurationSpace& startCS, const ConfigurationSpace& endCS);
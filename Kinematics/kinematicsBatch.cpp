@@ -0,0 +1,239 @@
+#define _USE_MATH_DEFINES
+#include "kinematicsBatch.h"
+#include "simd.h"
+#include <algorithm>
+
+using namespace simd;
+
+// loads lanes [i, i + width), repeating the last element past the end of the batch
+static vfloat loadLanes(const std::vector<float>& src, size_t i)
+{
+	if (i + width <= src.size())
+		return load(src.data() + i);
+
+	float lanes[width];
+	for (int k = 0; k < width; k++)
+		lanes[k] = src[std::min(i + k, src.size() - 1)];
+	return load(lanes);
+}
+
+static vvec3 loadLanes(const Vec3Batch& src, size_t i)
+{
+	return vvec3(loadLanes(src.x, i), loadLanes(src.y, i), loadLanes(src.z, i));
+}
+
+static void storeLanes(std::vector<float>& dst, size_t i, vfloat value)
+{
+	if (i + width <= dst.size()) {
+		store(dst.data() + i, value);
+		return;
+	}
+
+	float lanes[width];
+	store(lanes, value);
+	std::copy(lanes, lanes + (dst.size() - i), dst.begin() + i);
+}
+
+static void storeLanes(Vec3Batch& dst, size_t i, const vvec3& value)
+{
+	storeLanes(dst.x, i, value.x);
+	storeLanes(dst.y, i, value.y);
+	storeLanes(dst.z, i, value.z);
+}
+
+void solveInverseKinematicsBatch(const FrameBatch& effectors, const glm::vec3& lengths, IKBatchResult& result,
+	const Vec3Batch* prevP3)
+{
+	const size_t n = effectors.Size();
+	result.Resize(n);
+	result.p1 = baseFrame.GetOrigin();
+	result.p2 = result.p1 + baseFrame.GetZ() * lengths.x;
+
+	const vvec3 baseX = baseFrame.GetX();
+	const vvec3 baseY = baseFrame.GetY();
+	const vvec3 baseZ = baseFrame.GetZ();
+	const vvec3 p0 = baseFrame.GetOrigin();
+	const vvec3 p2 = result.p2;
+	const vvec3 v20 = normalize(p2 - p0);
+	const vfloat l2 = lengths.y;
+	const vfloat l3 = lengths.z;
+
+	for (size_t i = 0; i < n; i += width) {
+		// calculate joints positions
+		vvec3 p5 = loadLanes(effectors.origin, i);
+		vvec3 x5 = loadLanes(effectors.x, i);
+		vvec3 z5 = loadLanes(effectors.z, i);
+		vvec3 p4 = p5 - x5 * l3;
+
+		vvec3 v40 = normalize(p4 - p0);
+		vvec3 norm = normalize(cross(v40, v20));
+		vvec3 v34n = normalize(cross(norm, x5));
+
+		vvec3 p3 = p4 + v34n * l2;
+		vvec3 prev;
+		if (prevP3 != nullptr) {
+			// set p3 to the closest point to the previous p3
+			prev = loadLanes(*prevP3, i);
+			vvec3 p3alt = p4 - v34n * l2;
+			vvec3 toPrev = p3 - prev;
+			vvec3 altToPrev = p3alt - prev;
+			p3 = select(dot(altToPrev, altToPrev) < dot(toPrev, toPrev), p3alt, p3);
+		}
+
+		// case when v34 and x5 are parallel
+		vfloat p3NaN = isNaN(p3);
+		if (any(p3NaN)) {
+			vvec3 fallback = prevP3 != nullptr
+				? prev - norm * dot(prev, norm)
+				: p4 + normalize(p2 - p4) * l2;
+			p3 = select(p3NaN, fallback, p3);
+		}
+
+		// case when v40 and v20 are parallel
+		vfloat normNaN = isNaN(norm);
+		if (any(normNaN))
+			p3 = select(normNaN, p4 + normalize(p2 - p4) * l2, p3);
+
+		//-----------------------------------------------------------------------------//
+
+		// calculate configuration space, frame axes are rebuilt from direction cosines instead of rotations
+		vfloat q2 = length(p3 - p2);
+
+		// alpha1
+		vvec3 v40r = p4 - p0;
+		vfloat y1dot = dot(v40r, baseY);
+		vfloat x1dot = dot(v40r, baseX);
+		vfloat alpha1 = atan2(y1dot, x1dot);
+		vfloat c1, s1;
+		directionCosines(y1dot, x1dot, c1, s1);
+		vvec3 x1 = baseX * c1 + baseY * s1;
+		vvec3 y1 = baseY * c1 - baseX * s1;
+		vvec3 z1 = baseZ;
+
+		// alpha2
+		vvec3 v32 = p3 - p2;
+		vfloat z2dot = dot(v32, z1);
+		vfloat x2dot = dot(v32, x1);
+		vfloat alpha2 = -atan2(z2dot, x2dot);
+		vfloat c2, s2;
+		directionCosines(-z2dot, x2dot, c2, s2);
+		vvec3 x2 = x1 * c2 - z1 * s2;
+		vvec3 z2 = z1 * c2 + x1 * s2;
+
+		// alpha3
+		vvec3 v34 = p3 - p4;
+		vvec3 x3p = cross(y1, normalize(v34));
+		vfloat z3dot = dot(x3p, z2);
+		vfloat x3dot = dot(x3p, x2);
+		vfloat alpha3 = -atan2(z3dot, x3dot);
+		vfloat c3, s3;
+		directionCosines(-z3dot, x3dot, c3, s3);
+		vvec3 x3 = x2 * c3 - z2 * s3;
+
+		// alpha4
+		vfloat alpha4 = atan2(dot(x5, y1), dot(x5, x3));
+
+		// alpha5
+		vvec3 y4 = cross(x5, v34);
+		vfloat alpha5 = vfloat((float)M_PI_2) - atan2(dot(z5, v34), dot(z5, y4));
+		alpha5 = select(alpha5 > vfloat((float)M_PI), alpha5 - vfloat(2.f * (float)M_PI), alpha5);
+
+		storeLanes(result.configSpace.alpha1, i, alpha1);
+		storeLanes(result.configSpace.alpha2, i, alpha2);
+		storeLanes(result.configSpace.q2, i, q2);
+		storeLanes(result.configSpace.alpha3, i, alpha3);
+		storeLanes(result.configSpace.alpha4, i, alpha4);
+		storeLanes(result.configSpace.alpha5, i, alpha5);
+		storeLanes(result.p3, i, p3);
+		storeLanes(result.p4, i, p4);
+		storeLanes(result.p5, i, p5);
+	}
+}
+
+// frame axes and origin of simd::width samples
+struct FrameLanes {
+	vvec3 x;
+	vvec3 y;
+	vvec3 z;
+	vvec3 origin;
+};
+
+static void storeMatrices(std::vector<glm::mat4>& links, size_t i, const FrameLanes (&frames)[5])
+{
+	const size_t count = std::min<size_t>(width, links.size() / 5 - i);
+	float lanes[5][4][3][width];
+	for (int f = 0; f < 5; f++) {
+		const vvec3* columns[4] = { &frames[f].x, &frames[f].y, &frames[f].z, &frames[f].origin };
+		for (int c = 0; c < 4; c++) {
+			store(lanes[f][c][0], columns[c]->x);
+			store(lanes[f][c][1], columns[c]->y);
+			store(lanes[f][c][2], columns[c]->z);
+		}
+	}
+
+	for (size_t k = 0; k < count; k++) {
+		for (int f = 0; f < 5; f++) {
+			glm::mat4& matrix = links[5 * (i + k) + f];
+			for (int c = 0; c < 4; c++)
+				matrix[c] = glm::vec4(lanes[f][c][0][k], lanes[f][c][1][k], lanes[f][c][2][k], c == 3 ? 1.f : 0.f);
+		}
+	}
+}
+
+void calculateFramesFromConfSpaceBatch(const ConfigurationSpaceBatch& configSpaces, const glm::vec3& lengths,
+	std::vector<glm::mat4>& links)
+{
+	const size_t n = configSpaces.Size();
+	links.resize(5 * n);
+
+	const vvec3 baseX = baseFrame.GetX();
+	const vvec3 baseY = baseFrame.GetY();
+	const vvec3 baseZ = baseFrame.GetZ();
+	const vvec3 p0 = baseFrame.GetOrigin();
+	const vfloat l1 = lengths.x;
+	const vfloat l2 = lengths.y;
+	const vfloat l3 = lengths.z;
+
+	FrameLanes F[5];
+	for (size_t i = 0; i < n; i += width) {
+		vfloat c1, s1, c2, s2, c3, s3, c4, s4, c5, s5;
+		sincos(loadLanes(configSpaces.alpha1, i), s1, c1);
+		sincos(loadLanes(configSpaces.alpha2, i), s2, c2);
+		sincos(loadLanes(configSpaces.alpha3, i), s3, c3);
+		sincos(loadLanes(configSpaces.alpha4, i), s4, c4);
+		sincos(loadLanes(configSpaces.alpha5, i), s5, c5);
+		vfloat q2 = loadLanes(configSpaces.q2, i);
+
+		// F1 - rotation around base Z
+		F[0].x = baseX * c1 + baseY * s1;
+		F[0].y = baseY * c1 - baseX * s1;
+		F[0].z = baseZ;
+		F[0].origin = p0;
+
+		// F2 - translation along Z1, rotation around Y1
+		F[1].x = F[0].x * c2 - F[0].z * s2;
+		F[1].y = F[0].y;
+		F[1].z = F[0].z * c2 + F[0].x * s2;
+		F[1].origin = F[0].origin + F[0].z * l1;
+
+		// F3 - translation along X2, rotation around Y2
+		F[2].x = F[1].x * c3 - F[1].z * s3;
+		F[2].y = F[1].y;
+		F[2].z = F[1].z * c3 + F[1].x * s3;
+		F[2].origin = F[1].origin + F[1].x * q2;
+
+		// F4 - translation along -Z3, rotation around Z3
+		F[3].x = F[2].x * c4 + F[2].y * s4;
+		F[3].y = F[2].y * c4 - F[2].x * s4;
+		F[3].z = F[2].z;
+		F[3].origin = F[2].origin - F[2].z * l2;
+
+		// F5 - translation along X4, rotation around X4
+		F[4].x = F[3].x;
+		F[4].y = F[3].y * c5 + F[3].z * s5;
+		F[4].z = F[3].z * c5 - F[3].y * s5;
+		F[4].origin = F[3].origin + F[3].x * l3;
+
+		storeMatrices(links, i, F);
+	}
+}
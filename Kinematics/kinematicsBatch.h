@@ -0,0 +1,138 @@
+#pragma once
+
+#include "glm/glm.hpp"
+#include <vector>
+#include "kinematics.h"
+
+// Structure-of-arrays block of 3D vectors
+struct Vec3Batch {
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> z;
+
+	size_t Size() const { return x.size(); }
+
+	void Resize(size_t n) {
+		x.resize(n);
+		y.resize(n);
+		z.resize(n);
+	}
+
+	void Reserve(size_t n) {
+		x.reserve(n);
+		y.reserve(n);
+		z.reserve(n);
+	}
+
+	void Push(const glm::vec3& v) {
+		x.push_back(v.x);
+		y.push_back(v.y);
+		z.push_back(v.z);
+	}
+
+	glm::vec3 Get(size_t i) const {
+		return glm::vec3(x[i], y[i], z[i]);
+	}
+};
+
+// Effector poses in SoA layout, only the axes used by the IK are kept
+struct FrameBatch {
+	Vec3Batch origin;
+	Vec3Batch x;
+	Vec3Batch z;
+
+	size_t Size() const { return origin.Size(); }
+
+	void Reserve(size_t n) {
+		origin.Reserve(n);
+		x.Reserve(n);
+		z.Reserve(n);
+	}
+
+	void Push(const Frame& frame) {
+		origin.Push(frame.GetOrigin());
+		x.Push(frame.GetX());
+		z.Push(frame.GetZ());
+	}
+
+	void Push(const Transform& frame) {
+		origin.Push(frame.GetOrigin());
+		x.Push(frame.GetX());
+		z.Push(frame.GetZ());
+	}
+};
+
+struct ConfigurationSpaceBatch {
+	std::vector<float> alpha1;
+	std::vector<float> alpha2;
+	std::vector<float> q2;
+	std::vector<float> alpha3;
+	std::vector<float> alpha4;
+	std::vector<float> alpha5;
+
+	size_t Size() const { return alpha1.size(); }
+
+	void Resize(size_t n) {
+		alpha1.resize(n);
+		alpha2.resize(n);
+		q2.resize(n);
+		alpha3.resize(n);
+		alpha4.resize(n);
+		alpha5.resize(n);
+	}
+
+	void Reserve(size_t n) {
+		alpha1.reserve(n);
+		alpha2.reserve(n);
+		q2.reserve(n);
+		alpha3.reserve(n);
+		alpha4.reserve(n);
+		alpha5.reserve(n);
+	}
+
+	void Push(const ConfigurationSpace& configSpace) {
+		alpha1.push_back(configSpace.alpha1);
+		alpha2.push_back(configSpace.alpha2);
+		q2.push_back(configSpace.q2);
+		alpha3.push_back(configSpace.alpha3);
+		alpha4.push_back(configSpace.alpha4);
+		alpha5.push_back(configSpace.alpha5);
+	}
+
+	ConfigurationSpace Get(size_t i) const {
+		return ConfigurationSpace(alpha1[i], alpha2[i], q2[i], alpha3[i], alpha4[i], alpha5[i]);
+	}
+};
+
+struct IKBatchResult {
+	ConfigurationSpaceBatch configSpace;
+	// p1 and p2 only depend on the lengths, so they are shared by the whole batch
+	glm::vec3 p1;
+	glm::vec3 p2;
+	Vec3Batch p3;
+	Vec3Batch p4;
+	Vec3Batch p5;
+
+	size_t Size() const { return configSpace.Size(); }
+
+	void Resize(size_t n) {
+		configSpace.Resize(n);
+		p3.Resize(n);
+		p4.Resize(n);
+		p5.Resize(n);
+	}
+
+	Joints GetJoints(size_t i) const {
+		return Joints(p1, p2, p3.Get(i), p4.Get(i), p5.Get(i));
+	}
+};
+
+// Batched counterpart of solveInverseKinematics, evaluated simd::width effectors at a time.
+// prevP3 (optional) holds, per effector, the p3 of the previous pose used to pick the closer elbow solution.
+void solveInverseKinematicsBatch(const FrameBatch& effectors, const glm::vec3& lengths, IKBatchResult& result,
+	const Vec3Batch* prevP3 = nullptr);
+
+// Batched counterpart of calculateFramesFromConfSpace. Writes the F1..F5 matrices of sample i
+// to links[5 * i] .. links[5 * i + 4], the same matrices Frame::GetMatrix would return.
+void calculateFramesFromConfSpaceBatch(const ConfigurationSpaceBatch& configSpaces, const glm::vec3& lengths,
+	std::vector<glm::mat4>& links);
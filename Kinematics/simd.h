@@ -0,0 +1,199 @@
+#pragma once
+
+#include <immintrin.h>
+#include "glm/glm.hpp"
+
+// Thin wrappers over SSE2/AVX2 registers used by the batched kinematics.
+// Lane count is chosen at compile time: 8 lanes when the compiler targets AVX2 (/arch:AVX2), 4 otherwise.
+namespace simd
+{
+#if defined(__AVX2__)
+	constexpr int width = 8;
+
+	struct vfloat {
+		__m256 v;
+		vfloat() = default;
+		vfloat(__m256 v) : v(v) {}
+		vfloat(float s) : v(_mm256_set1_ps(s)) {}
+	};
+
+	struct vint {
+		__m256i v;
+		vint() = default;
+		vint(__m256i v) : v(v) {}
+		vint(int s) : v(_mm256_set1_epi32(s)) {}
+	};
+
+	inline vfloat load(const float* p) { return _mm256_loadu_ps(p); }
+	inline void store(float* p, vfloat a) { _mm256_storeu_ps(p, a.v); }
+
+	inline vfloat operator+(vfloat a, vfloat b) { return _mm256_add_ps(a.v, b.v); }
+	inline vfloat operator-(vfloat a, vfloat b) { return _mm256_sub_ps(a.v, b.v); }
+	inline vfloat operator*(vfloat a, vfloat b) { return _mm256_mul_ps(a.v, b.v); }
+	inline vfloat operator/(vfloat a, vfloat b) { return _mm256_div_ps(a.v, b.v); }
+	inline vfloat operator&(vfloat a, vfloat b) { return _mm256_and_ps(a.v, b.v); }
+	inline vfloat operator|(vfloat a, vfloat b) { return _mm256_or_ps(a.v, b.v); }
+	inline vfloat operator^(vfloat a, vfloat b) { return _mm256_xor_ps(a.v, b.v); }
+	inline vfloat andnot(vfloat a, vfloat b) { return _mm256_andnot_ps(a.v, b.v); }
+	inline vfloat sqrt(vfloat a) { return _mm256_sqrt_ps(a.v); }
+
+	inline vfloat operator<(vfloat a, vfloat b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+	inline vfloat operator>(vfloat a, vfloat b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+	inline vfloat operator==(vfloat a, vfloat b) { return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); }
+	inline vfloat isNaN(vfloat a) { return _mm256_cmp_ps(a.v, a.v, _CMP_UNORD_Q); }
+
+	// picks a where the mask is set, b elsewhere
+	inline vfloat select(vfloat mask, vfloat a, vfloat b) { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+	inline bool any(vfloat mask) { return _mm256_movemask_ps(mask.v) != 0; }
+
+	inline vint truncate(vfloat a) { return _mm256_cvttps_epi32(a.v); }
+	inline vfloat toFloat(vint a) { return _mm256_cvtepi32_ps(a.v); }
+	inline vfloat asFloat(vint a) { return _mm256_castsi256_ps(a.v); }
+	inline vint operator+(vint a, vint b) { return _mm256_add_epi32(a.v, b.v); }
+	inline vint operator-(vint a, vint b) { return _mm256_sub_epi32(a.v, b.v); }
+	inline vint operator&(vint a, vint b) { return _mm256_and_si256(a.v, b.v); }
+	inline vint andnot(vint a, vint b) { return _mm256_andnot_si256(a.v, b.v); }
+	inline vint operator==(vint a, vint b) { return _mm256_cmpeq_epi32(a.v, b.v); }
+	inline vint shiftLeft(vint a, int bits) { return _mm256_slli_epi32(a.v, bits); }
+#else
+	constexpr int width = 4;
+
+	struct vfloat {
+		__m128 v;
+		vfloat() = default;
+		vfloat(__m128 v) : v(v) {}
+		vfloat(float s) : v(_mm_set1_ps(s)) {}
+	};
+
+	struct vint {
+		__m128i v;
+		vint() = default;
+		vint(__m128i v) : v(v) {}
+		vint(int s) : v(_mm_set1_epi32(s)) {}
+	};
+
+	inline vfloat load(const float* p) { return _mm_loadu_ps(p); }
+	inline void store(float* p, vfloat a) { _mm_storeu_ps(p, a.v); }
+
+	inline vfloat operator+(vfloat a, vfloat b) { return _mm_add_ps(a.v, b.v); }
+	inline vfloat operator-(vfloat a, vfloat b) { return _mm_sub_ps(a.v, b.v); }
+	inline vfloat operator*(vfloat a, vfloat b) { return _mm_mul_ps(a.v, b.v); }
+	inline vfloat operator/(vfloat a, vfloat b) { return _mm_div_ps(a.v, b.v); }
+	inline vfloat operator&(vfloat a, vfloat b) { return _mm_and_ps(a.v, b.v); }
+	inline vfloat operator|(vfloat a, vfloat b) { return _mm_or_ps(a.v, b.v); }
+	inline vfloat operator^(vfloat a, vfloat b) { return _mm_xor_ps(a.v, b.v); }
+	inline vfloat andnot(vfloat a, vfloat b) { return _mm_andnot_ps(a.v, b.v); }
+	inline vfloat sqrt(vfloat a) { return _mm_sqrt_ps(a.v); }
+
+	inline vfloat operator<(vfloat a, vfloat b) { return _mm_cmplt_ps(a.v, b.v); }
+	inline vfloat operator>(vfloat a, vfloat b) { return _mm_cmpgt_ps(a.v, b.v); }
+	inline vfloat operator==(vfloat a, vfloat b) { return _mm_cmpeq_ps(a.v, b.v); }
+	inline vfloat isNaN(vfloat a) { return _mm_cmpunord_ps(a.v, a.v); }
+
+	// picks a where the mask is set, b elsewhere (SSE2 has no blendv)
+	inline vfloat select(vfloat mask, vfloat a, vfloat b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+	inline bool any(vfloat mask) { return _mm_movemask_ps(mask.v) != 0; }
+
+	inline vint truncate(vfloat a) { return _mm_cvttps_epi32(a.v); }
+	inline vfloat toFloat(vint a) { return _mm_cvtepi32_ps(a.v); }
+	inline vfloat asFloat(vint a) { return _mm_castsi128_ps(a.v); }
+	inline vint operator+(vint a, vint b) { return _mm_add_epi32(a.v, b.v); }
+	inline vint operator-(vint a, vint b) { return _mm_sub_epi32(a.v, b.v); }
+	inline vint operator&(vint a, vint b) { return _mm_and_si128(a.v, b.v); }
+	inline vint andnot(vint a, vint b) { return _mm_andnot_si128(a.v, b.v); }
+	inline vint operator==(vint a, vint b) { return _mm_cmpeq_epi32(a.v, b.v); }
+	inline vint shiftLeft(vint a, int bits) { return _mm_slli_epi32(a.v, bits); }
+#endif
+
+	inline vfloat operator-(vfloat a) { return a ^ vfloat(-0.f); }
+	inline vfloat abs(vfloat a) { return andnot(vfloat(-0.f), a); }
+	inline vfloat signBit(vfloat a) { return a & vfloat(-0.f); }
+
+	// Cephes-style atan2, max error around 2 ulp; atan2(0, 0) = 0 like std::atan2
+	inline vfloat atan2(vfloat y, vfloat x)
+	{
+		vfloat ax = abs(x);
+		vfloat ay = abs(y);
+
+		// reduce to [0, 1] and then to [-tan(pi/8), tan(pi/8)]
+		vfloat swap = ay > ax;
+		vfloat num = select(swap, ax, ay);
+		vfloat den = select(swap, ay, ax);
+		vfloat q = select(den == vfloat(0.f), vfloat(0.f), num / den);
+
+		vfloat big = q > vfloat(0.41421356f);
+		vfloat r = select(big, (q - vfloat(1.f)) / (q + vfloat(1.f)), q);
+		vfloat offset = select(big, vfloat(0.78539816f), vfloat(0.f));
+
+		vfloat z = r * r;
+		vfloat p = ((((vfloat(8.05374449538e-2f) * z - vfloat(1.38776856032e-1f)) * z
+			+ vfloat(1.99777106478e-1f)) * z - vfloat(3.33329491539e-1f)) * z) * r + r + offset;
+
+		p = select(swap, vfloat(1.57079633f) - p, p);
+		p = select(x < vfloat(0.f), vfloat(3.14159265f) - p, p);
+		return p ^ signBit(y);
+	}
+
+	// Cephes-style sin and cos evaluated together, accurate for |x| < 8192
+	inline void sincos(vfloat x, vfloat& s, vfloat& c)
+	{
+		vfloat sign = signBit(x);
+		x = abs(x);
+
+		// octant index rounded up to even, the remainder lands in [-pi/4, pi/4]
+		vint j = truncate(x * vfloat(1.27323954f));
+		j = (j + vint(1)) & vint(~1);
+		vfloat y = toFloat(j);
+		x = ((x - y * vfloat(0.78515625f)) - y * vfloat(2.4187564849853515625e-4f)) - y * vfloat(3.77489497744594108e-8f);
+
+		vfloat sinSign = sign ^ asFloat(shiftLeft(j & vint(4), 29));
+		vfloat cosSign = asFloat(shiftLeft(andnot(j - vint(2), vint(4)), 29));
+		vfloat polyMask = asFloat((j & vint(2)) == vint(0));
+
+		vfloat z = x * x;
+		vfloat cosPoly = ((vfloat(2.443315711809948e-5f) * z - vfloat(1.388731625493765e-3f)) * z
+			+ vfloat(4.166664568298827e-2f)) * z * z - vfloat(0.5f) * z + vfloat(1.f);
+		vfloat sinPoly = ((vfloat(-1.9515295891e-4f) * z + vfloat(8.3321608736e-3f)) * z
+			- vfloat(1.6666654611e-1f)) * z * x + x;
+
+		s = select(polyMask, sinPoly, cosPoly) ^ sinSign;
+		c = select(polyMask, cosPoly, sinPoly) ^ cosSign;
+	}
+
+	// cos and sin of atan2(y, x) without evaluating the angle, (1, 0) for a zero vector
+	inline void directionCosines(vfloat y, vfloat x, vfloat& c, vfloat& s)
+	{
+		vfloat h = sqrt(x * x + y * y);
+		vfloat zero = h == vfloat(0.f);
+		c = select(zero, vfloat(1.f), x / h);
+		s = select(zero, vfloat(0.f), y / h);
+	}
+
+	struct vvec3 {
+		vfloat x, y, z;
+		vvec3() = default;
+		vvec3(vfloat x, vfloat y, vfloat z) : x(x), y(y), z(z) {}
+		vvec3(const glm::vec3& v) : x(v.x), y(v.y), z(v.z) {}
+	};
+
+	inline vvec3 operator+(const vvec3& a, const vvec3& b) { return vvec3(a.x + b.x, a.y + b.y, a.z + b.z); }
+	inline vvec3 operator-(const vvec3& a, const vvec3& b) { return vvec3(a.x - b.x, a.y - b.y, a.z - b.z); }
+	inline vvec3 operator*(const vvec3& a, vfloat s) { return vvec3(a.x * s, a.y * s, a.z * s); }
+
+	inline vfloat dot(const vvec3& a, const vvec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+	inline vvec3 cross(const vvec3& a, const vvec3& b)
+	{
+		return vvec3(
+			a.y * b.z - a.z * b.y,
+			a.z * b.x - a.x * b.z,
+			a.x * b.y - a.y * b.x);
+	}
+	inline vfloat length(const vvec3& a) { return sqrt(dot(a, a)); }
+	// NaN for a zero vector, same as glm::normalize
+	inline vvec3 normalize(const vvec3& a) { vfloat l = length(a); return vvec3(a.x / l, a.y / l, a.z / l); }
+	inline vfloat isNaN(const vvec3& a) { return isNaN(a.x) | isNaN(a.y) | isNaN(a.z); }
+	inline vvec3 select(vfloat mask, const vvec3& a, const vvec3& b)
+	{
+		return vvec3(select(mask, a.x, b.x), select(mask, a.y, b.y), select(mask, a.z, b.z));
+	}
+}
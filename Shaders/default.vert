@@ -1,8 +1,11 @@
 #version 460 core
+#extension GL_ARB_shader_viewport_layer_array : enable
 layout (location = 0) in vec3 pos;
-uniform mat4 view;
-uniform mat4 proj;
+#include "frameUniforms.glsl"
 void main()
 {
    gl_Position = proj * view * vec4(pos, 1.0);
+#ifdef GL_ARB_shader_viewport_layer_array
+   gl_ViewportIndex = gl_InstanceID;
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,12 @@
+layout (std140, binding = 0) uniform FrameUniforms {
+    mat4 view;
+    mat4 proj;
+    // also converts the Z-up model space to the Y-up scene
+    mat4 phongView;
+    vec4 viewPos;
+    vec4 lightPos;
+    vec4 lightColor;
+    float ambientStrength;
+    float specularStrength;
+    float shininess;
+};
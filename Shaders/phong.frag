@@ -2,31 +2,25 @@
 
 in vec3 normal;  
 in vec3 fragPos;  
+in vec4 objectColor;
 
 out vec4 FragColor;
   
-uniform vec3 viewPos; 
-uniform vec4 objectColor;
-
-const float ambientStrength = 0.01f;
-const float specularStrength = 0.5f;
-
-const vec3 lightColor  = vec3(1.f, 1.f, 1.f);
-const vec3 lightPos	= vec3(300.f, 300.f, 300.f);
+#include "frameUniforms.glsl"
 
 void main()
 {
-    vec3 ambient = ambientStrength * lightColor;
+    vec3 ambient = ambientStrength * lightColor.xyz;
   	
     vec3 norm = normalize(normal);
-    vec3 lightDir = normalize(lightPos - fragPos);
+    vec3 lightDir = normalize(lightPos.xyz - fragPos);
     float diff = max(dot(norm, lightDir), 0.f);
-    vec3 diffuse = diff * lightColor;
+    vec3 diffuse = diff * lightColor.xyz;
     
-    vec3 viewDir = normalize(viewPos - fragPos);
+    vec3 viewDir = normalize(viewPos.xyz - fragPos);
     vec3 halfwayDir = normalize(lightDir + viewDir);  
-    float spec = pow(max(dot(norm, halfwayDir), 0.f), 2.f);
-    vec3 specular = specularStrength * spec * lightColor;  
+    float spec = pow(max(dot(norm, halfwayDir), 0.f), shininess);
+    vec3 specular = specularStrength * spec * lightColor.xyz;  
         
     vec3 result = (ambient + diffuse + specular) * objectColor.xyz;
 
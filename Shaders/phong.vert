@@ -1,20 +1,38 @@
 #version 460 core
+#extension GL_ARB_shader_viewport_layer_array : enable
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 
 out vec3 fragPos;
 out vec3 normal;
+out vec4 objectColor;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 proj;
+struct Instance {
+    mat4 model;
+    mat3 normalMatrix;
+    vec4 color;
+};
+
+layout (std430, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+
+layout (std430, binding = 1) readonly buffer InstanceViewports {
+    int viewports[];
+};
+
+#include "frameUniforms.glsl"
 
 void main()
 {
-    vec4 position = vec4(aPos, 1.0);
-    vec4 worldPos = model * position;
-    vec4 newWorldPos = vec4(worldPos.x, worldPos.z, -worldPos.y, worldPos.w);
-    fragPos = newWorldPos.xyz / newWorldPos.w;
-    gl_Position = proj * view * newWorldPos;
-    normal = mat3(transpose(inverse(model))) * aNormal;
+    int instance = gl_BaseInstance + gl_InstanceID;
+    vec4 worldPos = instances[instance].model * vec4(aPos, 1.0);
+    fragPos = worldPos.xyz;
+    gl_Position = proj * phongView * worldPos;
+    normal = instances[instance].normalMatrix * aNormal;
+    objectColor = instances[instance].color;
+#ifdef GL_ARB_shader_viewport_layer_array
+    // in the per-viewport fallback every viewport holds the same rectangle, so the index is harmless
+    gl_ViewportIndex = viewports[instance];
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "Histogram.h"
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+static int failures = 0;
+
+static void check(bool condition, const char* what, uint64_t value)
+{
+	if (!condition) {
+		std::cout << "FAILED: " << what << " for " << value << std::endl;
+		failures++;
+	}
+}
+
+// Values at and past the top of the tracked range must land in the last bucket instead of past the table
+int main()
+{
+	const uint64_t top = (uint64_t(1) << 40) - 1;
+	for (uint64_t value : { top, top + 1, UINT64_MAX }) {
+		auto histogram = std::make_unique<Histogram>();
+		histogram->Record(value);
+
+		int last = histogram->GetBucketCount() - 1;
+		check(histogram->GetBucketCountAt(last) == 1, "recorded into the top bucket", value);
+		check(histogram->GetBucketLow(last) <= top && histogram->GetBucketHigh(last) == top, "top bucket range", value);
+		check(histogram->GetValueAtPercentile(100.0) == top, "100th percentile", value);
+		check(histogram->GetMax() == value, "max", value);
+	}
+
+	if (failures == 0)
+		std::cout << "Histogram: all checks passed" << std::endl;
+	return failures == 0 ? 0 : 1;
+}
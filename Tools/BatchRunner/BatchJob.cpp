@@ -0,0 +1,161 @@
+#define _USE_MATH_DEFINES
+#include "BatchJob.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+// same conversion the application applies to its position inputs
+static glm::vec3 changeCoordinateSystem(glm::vec3 vec)
+{
+	return glm::vec3(vec.x, -vec.z, vec.y);
+}
+
+static float orInfinity(float value)
+{
+	return std::isnan(value) ? std::numeric_limits<float>::infinity() : value;
+}
+
+std::vector<BatchJob> readJobFile(const std::string& path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+		throw std::runtime_error("Failed to open file " + path);
+
+	std::vector<BatchJob> jobs;
+	// lower case, names become trace file names and Windows compares those without case
+	std::unordered_set<std::string> names;
+	std::string line;
+	int lineCounter = 0;
+	while (std::getline(file, line)) {
+		lineCounter++;
+		size_t comment = line.find('#');
+		if (comment != std::string::npos)
+			line.erase(comment);
+
+		std::istringstream stream(line);
+		BatchJob job;
+		if (!(stream >> job.name))
+			continue;
+
+		if (job.name.find_first_of("/\\:") != std::string::npos)
+			throw std::runtime_error("Job name \"" + job.name + "\" must not contain '/', '\\' or ':' in line#" + std::to_string(lineCounter));
+		std::string key = job.name;
+		std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+		if (!names.insert(key).second)
+			throw std::runtime_error("Duplicate job name \"" + job.name + "\" in line#" + std::to_string(lineCounter));
+
+		float values[16];
+		for (float& value : values) {
+			if (!(stream >> value))
+				throw std::runtime_error("Expected 16 numbers after the job name in line#" + std::to_string(lineCounter));
+		}
+		std::string extra;
+		if (stream >> extra)
+			throw std::runtime_error("Unexpected \"" + extra + "\" in line#" + std::to_string(lineCounter));
+
+		glm::vec3 startPos(values[0], values[1], values[2]);
+		glm::vec3 startEA(values[3], values[4], values[5]);
+		glm::vec3 endPos(values[6], values[7], values[8]);
+		glm::vec3 endEA(values[9], values[10], values[11]);
+		glm::vec3 lengths(values[12], values[13], values[14]);
+		float speed = values[15];
+		if (!(speed > 0.f))
+			throw std::runtime_error("Speed must be positive in line#" + std::to_string(lineCounter));
+
+		job.params = SymParams(
+			Transform(changeCoordinateSystem(startPos), glm::quat(glm::radians(startEA))),
+			Transform(changeCoordinateSystem(endPos), glm::quat(glm::radians(endEA))),
+			speed, lengths);
+		jobs.push_back(job);
+	}
+
+	return jobs;
+}
+
+JobSummary runJob(const BatchJob& job, float tickLength, float positionTolerance, float angleTolerance,
+	std::ostream* trace)
+{
+	const SymParams& params = job.params;
+
+	JobSummary summary;
+	summary.name = job.name;
+	summary.duration = 100.f / params.speed;
+
+	if (trace != nullptr) {
+		*trace << "tick,time,t,alpha1,alpha2,q2,alpha3,alpha4,alpha5,singular\n";
+		// enough digits to read every float back bit for bit
+		trace->precision(std::numeric_limits<float>::max_digits10);
+	}
+
+	Simulation simulation(params, tickLength);
+	ConfigurationSpace prevCS;
+	summary.tickCount = simulation.RunToCompletion([&](const Simulation& tick) {
+		const Transform& effectorFrame = tick.GetEffectorFrame();
+		if (tick.IsSingular())
+			summary.singularTicks++;
+
+		ConfigurationSpace cs = solveConfiguration(effectorFrame, params.lengths, tick.GetJoints()).configSpace;
+		if (trace != nullptr) {
+			*trace << tick.GetTick() << ',' << tick.GetTime() << ',' << tick.GetParameter() << ',' << cs.alpha1 << ','
+				<< cs.alpha2 << ',' << cs.q2 << ',' << cs.alpha3 << ',' << cs.alpha4 << ',' << cs.alpha5 << ','
+				<< tick.IsSingular() << '\n';
+		}
+
+		// divergence between the requested pose and the forward kinematics of the solution
+		Transform reached = calculateFramesFromConfSpace(cs, params.lengths)[4];
+		float positionError = orInfinity(glm::distance(reached.GetOrigin(), effectorFrame.GetOrigin()));
+		// angle of the relative rotation, from its vector part, which stays accurate for tiny angles unlike acos(w)
+		glm::quat difference = glm::inverse(reached.GetRotation()) * effectorFrame.GetRotation();
+		float sinHalfAngle = glm::length(glm::vec3(difference.x, difference.y, difference.z));
+		float rotationError = orInfinity(glm::degrees(2.f * std::atan2(sinHalfAngle, std::abs(difference.w))));
+		summary.maxPositionError = std::max(summary.maxPositionError, positionError);
+		summary.maxRotationError = std::max(summary.maxRotationError, rotationError);
+		if (!(positionError <= positionTolerance) || !(rotationError <= angleTolerance))
+			summary.divergentTicks++;
+
+		if (tick.GetTick() > 0) {
+			const float angles[5] = {
+				cs.alpha1 - prevCS.alpha1, cs.alpha2 - prevCS.alpha2, cs.alpha3 - prevCS.alpha3,
+				cs.alpha4 - prevCS.alpha4, cs.alpha5 - prevCS.alpha5
+			};
+			for (int joint = 0; joint < 5; joint++) {
+				float velocity = orInfinity(std::abs(normalizeAngle(angles[joint])) / tickLength);
+				if (velocity > summary.maxAngularVelocity) {
+					summary.maxAngularVelocity = velocity;
+					summary.maxAngularVelocityJoint = joint + 1;
+				}
+			}
+			summary.maxLinearVelocity = std::max(summary.maxLinearVelocity, orInfinity(std::abs(cs.q2 - prevCS.q2) / tickLength));
+		}
+		prevCS = cs;
+	});
+
+	return summary;
+}
+
+std::string jointName(int joint)
+{
+	return joint > 0 ? "alpha" + std::to_string(joint) : "-";
+}
+
+bool writeSummaryCsv(const std::string& path, const std::vector<JobSummary>& summaries)
+{
+	std::ofstream file(path);
+	if (!file)
+		return false;
+
+	file << "name,ticks,duration_s,max_angular_velocity_rad_s,max_angular_velocity_joint,max_q2_velocity,"
+		"singular_ticks,max_position_error,max_rotation_error_deg,divergent_ticks\n";
+	for (const JobSummary& summary : summaries) {
+		file << summary.name << ',' << summary.tickCount << ',' << summary.duration << ','
+			<< summary.maxAngularVelocity << ',' << jointName(summary.maxAngularVelocityJoint) << ',' << summary.maxLinearVelocity << ','
+			<< summary.singularTicks << ',' << summary.maxPositionError << ',' << summary.maxRotationError << ','
+			<< summary.divergentTicks << '\n';
+	}
+	return file.good();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Simulation.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// One trajectory of a job file. A job file has one job per line, '#' starts a comment:
+//   name  startX startY startZ  startPitch startYaw startRoll  endX endY endZ  endPitch endYaw endRoll  L1 L3 L4  speed
+// Positions, Euler angles (degrees), lengths and speed (%/s) mean the same as the inputs of the application.
+struct BatchJob {
+	std::string name;
+	SymParams params;
+};
+
+// Results of one job, gathered over the effector space (IK) motion at every tick
+struct JobSummary {
+	std::string name;
+	size_t tickCount = 0;
+	float duration = 0.f;				// simulated seconds
+	float maxAngularVelocity = 0.f;		// rad/s, over alpha1..alpha5
+	int maxAngularVelocityJoint = 0;	// 1..5
+	float maxLinearVelocity = 0.f;		// q2 change in units/s
+	// ticks at or next to a singular pose, see calculateJoints
+	size_t singularTicks = 0;
+	// forward kinematics of the solved configuration against the requested effector pose
+	float maxPositionError = 0.f;
+	float maxRotationError = 0.f;		// degrees
+	size_t divergentTicks = 0;
+};
+
+// Throws std::runtime_error naming the line on malformed input. Names must be unique (ignoring case) and free of
+// path separators, they name the trace files.
+std::vector<BatchJob> readJobFile(const std::string& path);
+
+// Steps the job at a fixed tickLength (seconds) as fast as possible. A tick diverges when its position error
+// exceeds positionTolerance or its rotation error exceeds angleTolerance (degrees); NaNs always diverge.
+// trace (optional) receives one CSV row per tick, identical on every run with the same job and tick length.
+JobSummary runJob(const BatchJob& job, float tickLength, float positionTolerance, float angleTolerance,
+	std::ostream* trace = nullptr);
+
+// "alpha1".."alpha5", "-" when no joint moved
+std::string jointName(int joint);
+
+bool writeSummaryCsv(const std::string& path, const std::vector<JobSummary>& summaries);
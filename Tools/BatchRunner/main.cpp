@@ -0,0 +1,112 @@
+#define _USE_MATH_DEFINES
+#include "BatchJob.h"
+#include "parallel.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// Runs every trajectory of a job file without a window, faster than real time and on all cores.
+// Exits with 1 when any job diverges, 2 on bad arguments or input.
+static void printUsage()
+{
+	std::cout << "usage: BatchRunner <job file> [--output summary.csv] [--trace directory] [--tick-rate Hz]" << std::endl
+		<< "                   [--tolerance units] [--angle-tolerance degrees]" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+	std::string jobPath;
+	std::string outputPath;
+	std::string tracePath;
+	int tickRate = defaultTickRate;
+	float positionTolerance = 1e-3f;
+	float angleTolerance = 0.01f;
+
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--output") == 0 && hasValue)
+			outputPath = argv[++i];
+		else if (strcmp(argv[i], "--trace") == 0 && hasValue)
+			tracePath = argv[++i];
+		else if (strcmp(argv[i], "--tick-rate") == 0 && hasValue)
+			tickRate = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--tolerance") == 0 && hasValue)
+			positionTolerance = (float)atof(argv[++i]);
+		else if (strcmp(argv[i], "--angle-tolerance") == 0 && hasValue)
+			angleTolerance = (float)atof(argv[++i]);
+		else if (argv[i][0] != '-' && jobPath.empty())
+			jobPath = argv[i];
+		else {
+			printUsage();
+			return 2;
+		}
+	}
+	if (jobPath.empty() || tickRate <= 0) {
+		printUsage();
+		return 2;
+	}
+
+	std::vector<BatchJob> jobs;
+	try {
+		jobs = readJobFile(jobPath);
+	}
+	catch (const std::exception& e) {
+		std::cout << e.what() << std::endl;
+		return 2;
+	}
+
+	// per tick samples of every job, e.g. to diff against a snapshot of a previous build
+	std::vector<std::ofstream> traces(jobs.size());
+	if (!tracePath.empty()) {
+		std::error_code error;
+		std::filesystem::create_directories(tracePath, error);
+		for (size_t i = 0; i < jobs.size(); i++) {
+			std::string path = (std::filesystem::path(tracePath) / (jobs[i].name + ".csv")).string();
+			traces[i].open(path);
+			if (!traces[i]) {
+				std::cout << "Failed to write " << path << std::endl;
+				return 2;
+			}
+		}
+	}
+
+	// every job chains its elbow solution tick by tick, so jobs rather than ticks are spread over the threads
+	const float tickLength = 1.f / tickRate;
+	std::vector<JobSummary> summaries(jobs.size());
+	auto start = std::chrono::steady_clock::now();
+	parallelFor(jobs.size(), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			std::ostream* trace = traces[i].is_open() ? &traces[i] : nullptr;
+			summaries[i] = runJob(jobs[i], tickLength, positionTolerance, angleTolerance, trace);
+		}
+	});
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	int failed = 0;
+	double simulated = 0.0;
+	printf("%-24s %8s %12s %8s %10s %9s %12s %10s\n",
+		"job", "ticks", "max w[r/s]", "joint", "max q2'", "singular", "max err", "max [deg]");
+	for (const JobSummary& summary : summaries) {
+		simulated += summary.duration;
+		if (summary.divergentTicks > 0)
+			failed++;
+		printf("%-24s %8zu %12.4g %8s %10.4g %9zu %12.4g %10.4g%s\n",
+			summary.name.c_str(), summary.tickCount, summary.maxAngularVelocity, jointName(summary.maxAngularVelocityJoint).c_str(),
+			summary.maxLinearVelocity, summary.singularTicks, summary.maxPositionError, summary.maxRotationError,
+			summary.divergentTicks > 0 ? "  DIVERGED" : "");
+	}
+	printf("\n%zu jobs, %d diverged, %.1f s simulated in %.3f s (%.0fx real time)\n",
+		jobs.size(), failed, simulated, elapsed, elapsed > 0.0 ? simulated / elapsed : 0.0);
+
+	if (!outputPath.empty() && !writeSummaryCsv(outputPath, summaries)) {
+		std::cout << "Failed to write " << outputPath << std::endl;
+		return 2;
+	}
+
+	return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+#define _USE_MATH_DEFINES
+#include "ReferenceKinematics.h"
+#include <cmath>
+
+static const glm::dvec3 referenceUnitX = glm::dvec3(1.0, 0.0, 0.0);
+static const glm::dvec3 referenceUnitY = glm::dvec3(0.0, 1.0, 0.0);
+static const glm::dvec3 referenceUnitZ = glm::dvec3(0.0, 0.0, 1.0);
+
+static double normalizeAngle(const double angle)
+{
+	double newAngle = angle;
+	while (newAngle > M_PI) {
+		newAngle -= 2 * M_PI;
+	}
+	while (newAngle < -M_PI) {
+		newAngle += 2 * M_PI;
+	}
+	return newAngle;
+}
+
+static bool isNaN(const glm::dvec3& vec)
+{
+	return std::isnan(vec.x) || std::isnan(vec.y) || std::isnan(vec.z);
+}
+
+static ReferenceTransform rotationAbout(const glm::dvec3& translation, double angle, const glm::dvec3& axis)
+{
+	return ReferenceTransform(translation, glm::angleAxis(angle, axis));
+}
+
+std::array<ReferenceTransform, 5> referenceFramesFromConfSpace(const ReferenceConfiguration& configSpace,
+	const glm::dvec3& lengths)
+{
+	ReferenceTransform F1 = ReferenceTransform() * rotationAbout(glm::dvec3(0.0), configSpace.alpha1, referenceUnitZ);
+	ReferenceTransform F2 = F1 * rotationAbout(referenceUnitZ * lengths.x, configSpace.alpha2, referenceUnitY);
+	ReferenceTransform F3 = F2 * rotationAbout(referenceUnitX * configSpace.q2, configSpace.alpha3, referenceUnitY);
+	ReferenceTransform F4 = F3 * rotationAbout(referenceUnitZ * -lengths.y, configSpace.alpha4, referenceUnitZ);
+	ReferenceTransform F5 = F4 * rotationAbout(referenceUnitX * lengths.z, configSpace.alpha5, referenceUnitX);
+
+	return { F1, F2, F3, F4, F5 };
+}
+
+ReferenceIKSet referenceInverseKinematics(const ReferenceTransform& effectorFrame, const glm::dvec3& lengths)
+{
+	const ReferenceTransform base;
+
+	// joint positions, see calculateJoints
+	glm::dvec3 p0 = base.origin;
+	glm::dvec3 p1 = p0;
+	glm::dvec3 p2 = p1 + base.GetZ() * lengths.x;
+
+	glm::dvec3 p5 = effectorFrame.origin;
+	glm::dvec3 p4 = p5 - effectorFrame.GetX() * lengths.z;
+
+	glm::dvec3 v40 = glm::normalize(p4 - p0);
+	glm::dvec3 v20 = glm::normalize(p2 - p0);
+	glm::dvec3 normCross = glm::cross(v40, v20);
+	glm::dvec3 norm = glm::normalize(normCross);
+	glm::dvec3 v34Cross = glm::cross(norm, effectorFrame.GetX());
+	glm::dvec3 v34n = glm::normalize(v34Cross);
+
+	glm::dvec3 p3 = p4 + v34n * lengths.y;
+	if (isNaN(p3) || isNaN(norm)) {
+		glm::dvec3 v24 = glm::normalize(p2 - p4);
+		p3 = p4 + v24 * lengths.y;
+	}
+
+	// configuration space and link frames, see solveConfiguration
+	ReferenceIKSet ik;
+	ik.joints = { p1, p2, p3, p4, p5 };
+	ik.singular = !(glm::length(normCross) > singularityEpsilon) || !(glm::length(v34Cross) > singularityEpsilon);
+	ReferenceConfiguration& cs = ik.configSpace;
+
+	cs.q2 = glm::distance(p2, p3);
+
+	glm::dvec3 v40full = p4 - p0;
+	cs.alpha1 = normalizeAngle(std::atan2(glm::dot(v40full, base.GetY()), glm::dot(v40full, base.GetX())));
+	ReferenceTransform F1 = base * rotationAbout(glm::dvec3(0.0), cs.alpha1, referenceUnitZ);
+
+	glm::dvec3 v32 = p3 - p2;
+	cs.alpha2 = normalizeAngle(-std::atan2(glm::dot(v32, F1.GetZ()), glm::dot(v32, F1.GetX())));
+	ReferenceTransform F2 = F1 * rotationAbout(referenceUnitZ * lengths.x, cs.alpha2, referenceUnitY);
+
+	glm::dvec3 v34 = p3 - p4;
+	glm::dvec3 x3 = glm::cross(F2.GetY(), glm::normalize(v34));
+	cs.alpha3 = normalizeAngle(-std::atan2(glm::dot(x3, F2.GetZ()), glm::dot(x3, F2.GetX())));
+	ReferenceTransform F3 = F2 * rotationAbout(referenceUnitX * cs.q2, cs.alpha3, referenceUnitY);
+
+	glm::dvec3 x5 = effectorFrame.GetX();
+	cs.alpha4 = normalizeAngle(std::atan2(glm::dot(x5, F3.GetY()), glm::dot(x5, F3.GetX())));
+	ReferenceTransform F4 = F3 * rotationAbout(referenceUnitZ * -lengths.y, cs.alpha4, referenceUnitZ);
+
+	glm::dvec3 y4 = glm::cross(x5, v34);
+	glm::dvec3 z5 = effectorFrame.GetZ();
+	cs.alpha5 = normalizeAngle(M_PI_2 - std::atan2(glm::dot(z5, v34), glm::dot(z5, y4)));
+	ReferenceTransform F5 = F4 * rotationAbout(referenceUnitX * lengths.z, cs.alpha5, referenceUnitX);
+
+	ik.frames = { F1, F2, F3, F4, F5 };
+	return ik;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "kinematics.h"
+#include <glm/gtc/quaternion.hpp>
+#include <array>
+
+// Double precision port of the kinematics in kinematics.h, the reference the float code is measured against.
+// Follows the float code step by step, so any difference between the two is rounding and not the algorithm.
+struct ReferenceTransform {
+	glm::dvec3 origin;
+	glm::dquat rotation;
+
+	ReferenceTransform() : origin(0.0), rotation(1.0, 0.0, 0.0, 0.0) {}
+
+	ReferenceTransform(glm::dvec3 origin, glm::dquat rotation) :
+		origin(origin), rotation(rotation) {}
+
+	glm::dvec3 GetX() const { return rotation * glm::dvec3(1.0, 0.0, 0.0); }
+	glm::dvec3 GetY() const { return rotation * glm::dvec3(0.0, 1.0, 0.0); }
+	glm::dvec3 GetZ() const { return rotation * glm::dvec3(0.0, 0.0, 1.0); }
+
+	// other is expressed in the local coordinates of this transform
+	ReferenceTransform operator*(const ReferenceTransform& other) const {
+		return ReferenceTransform(origin + rotation * other.origin, rotation * other.rotation);
+	}
+};
+
+struct ReferenceConfiguration {
+	double alpha1;
+	double alpha2;
+	double q2;
+	double alpha3;
+	double alpha4;
+	double alpha5;
+
+	ReferenceConfiguration() :
+		alpha1(0.0), alpha2(0.0), q2(0.0), alpha3(0.0), alpha4(0.0), alpha5(0.0) {}
+
+	explicit ReferenceConfiguration(const ConfigurationSpace& configSpace) :
+		alpha1(configSpace.alpha1), alpha2(configSpace.alpha2), q2(configSpace.q2),
+		alpha3(configSpace.alpha3), alpha4(configSpace.alpha4), alpha5(configSpace.alpha5) {}
+};
+
+struct ReferenceIKSet {
+	// p1..p5
+	std::array<glm::dvec3, 5> joints;
+	ReferenceConfiguration configSpace;
+	std::array<ReferenceTransform, 5> frames;
+	// same test as calculateJoints
+	bool singular;
+};
+
+// counterpart of calculateFramesFromConfSpace
+std::array<ReferenceTransform, 5> referenceFramesFromConfSpace(const ReferenceConfiguration& configSpace,
+	const glm::dvec3& lengths);
+
+// counterpart of solveInverseKinematics without a previous solution
+ReferenceIKSet referenceInverseKinematics(const ReferenceTransform& effectorFrame, const glm::dvec3& lengths);
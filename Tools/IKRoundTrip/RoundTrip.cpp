@@ -0,0 +1,125 @@
+#define _USE_MATH_DEFINES
+#include "RoundTrip.h"
+#include "ReferenceKinematics.h"
+#include <algorithm>
+#include <cmath>
+
+// SplitMix64 step, a counter based generator so every sample can be drawn independently
+static uint64_t splitMix64(uint64_t& state)
+{
+	uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+
+// uniform in [low, high)
+static float uniform(uint64_t& state, float low, float high)
+{
+	return low + (high - low) * (float)(splitMix64(state) >> 40) * (1.f / (1 << 24));
+}
+
+ConfigurationSpace sampleConfiguration(uint64_t seed, uint64_t index)
+{
+	uint64_t state = seed ^ (index * 0xD1B54A32D192ED03ull);
+	const float pi = (float)M_PI;
+	float alpha1 = uniform(state, -pi, pi);
+	float alpha2 = uniform(state, -pi, pi);
+	float q2 = uniform(state, 0.5f, 6.f);
+	float alpha3 = uniform(state, -pi, pi);
+	float alpha4 = uniform(state, -pi, pi);
+	float alpha5 = uniform(state, -pi, pi);
+	return ConfigurationSpace(alpha1, alpha2, q2, alpha3, alpha4, alpha5);
+}
+
+// angle of the relative rotation, from its vector part, which stays accurate for tiny angles unlike acos(w)
+template <typename Quat>
+static float rotationAngle(const Quat& a, const Quat& b)
+{
+	Quat difference = glm::inverse(a) * b;
+	auto sinHalfAngle = std::sqrt(difference.x * difference.x + difference.y * difference.y + difference.z * difference.z);
+	return (float)glm::degrees(2.0 * std::atan2((double)sinHalfAngle, std::abs((double)difference.w)));
+}
+
+RoundTripSample roundTrip(const ConfigurationSpace& configSpace, const glm::vec3& lengths)
+{
+	Transform effectorFrame = calculateFramesFromConfSpace(configSpace, lengths)[4];
+
+	RoundTripSample sample;
+	Joints joints = calculateJoints(effectorFrame, lengths, nullptr, &sample.singular);
+	IKSet ik = solveConfiguration(effectorFrame, lengths, joints);
+	Transform reached = calculateFramesFromConfSpace(ik.configSpace, lengths)[4];
+
+	sample.positionError = glm::distance(reached.GetOrigin(), effectorFrame.GetOrigin());
+	sample.rotationError = rotationAngle(reached.GetRotation(), effectorFrame.GetRotation());
+	const glm::vec3 positions[5] = { joints.p1, joints.p2, joints.p3, joints.p4, joints.p5 };
+	sample.jointError = 0.f;
+	for (int i = 0; i < 5; i++) {
+		float distance = glm::distance(positions[i], ik.frames[i].GetOrigin());
+		sample.jointError = std::isnan(distance) ? distance : std::max(sample.jointError, distance);
+	}
+	sample.solution = ik.configSpace;
+	return sample;
+}
+
+RoundTripSample referenceRoundTrip(const ConfigurationSpace& configSpace, const glm::vec3& lengths)
+{
+	glm::dvec3 referenceLengths(lengths);
+	ReferenceTransform effectorFrame = referenceFramesFromConfSpace(ReferenceConfiguration(configSpace), referenceLengths)[4];
+	ReferenceIKSet ik = referenceInverseKinematics(effectorFrame, referenceLengths);
+	ReferenceTransform reached = referenceFramesFromConfSpace(ik.configSpace, referenceLengths)[4];
+
+	RoundTripSample sample;
+	sample.positionError = (float)glm::distance(reached.origin, effectorFrame.origin);
+	sample.rotationError = rotationAngle(reached.rotation, effectorFrame.rotation);
+	sample.jointError = 0.f;
+	for (int i = 0; i < 5; i++) {
+		float distance = (float)glm::distance(ik.joints[i], ik.frames[i].origin);
+		sample.jointError = std::isnan(distance) ? distance : std::max(sample.jointError, distance);
+	}
+	const ReferenceConfiguration& cs = ik.configSpace;
+	sample.solution = ConfigurationSpace((float)cs.alpha1, (float)cs.alpha2, (float)cs.q2, (float)cs.alpha3,
+		(float)cs.alpha4, (float)cs.alpha5);
+	sample.singular = ik.singular;
+	return sample;
+}
+
+float angleDeviation(const ConfigurationSpace& a, const ConfigurationSpace& b)
+{
+	ConfigurationSpace difference = calculateIterpolationDirection(a, b);
+	float deviation = std::max({ std::abs(difference.alpha1), std::abs(difference.alpha2), std::abs(difference.alpha3),
+		std::abs(difference.alpha4), std::abs(difference.alpha5) });
+	return glm::degrees(deviation);
+}
+
+ErrorDistribution summarizeErrors(const std::string& name, std::vector<float>& values)
+{
+	ErrorDistribution distribution;
+	distribution.name = name;
+
+	auto nanBegin = std::partition(values.begin(), values.end(), [](float value) { return !std::isnan(value); });
+	distribution.nanCount = values.end() - nanBegin;
+	size_t count = nanBegin - values.begin();
+	if (count == 0)
+		return distribution;
+
+	double sum = 0.0;
+	for (auto it = values.begin(); it != nanBegin; ++it)
+		sum += *it;
+	distribution.mean = sum / count;
+
+	// ascending percentiles, so every nth_element only has to sort the range above the previous one
+	auto begin = values.begin();
+	auto percentile = [&](double p) {
+		auto nth = values.begin() + std::min(count - 1, (size_t)(p / 100.0 * count));
+		std::nth_element(begin, nth, nanBegin);
+		begin = nth;
+		return *nth;
+	};
+	distribution.p50 = percentile(50.0);
+	distribution.p90 = percentile(90.0);
+	distribution.p99 = percentile(99.0);
+	distribution.p999 = percentile(99.9);
+	distribution.max = *std::max_element(begin, nanBegin);
+	return distribution;
+}
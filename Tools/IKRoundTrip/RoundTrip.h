@@ -0,0 +1,45 @@
+#pragma once
+
+#include "kinematics.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Errors of one FK -> IK -> FK round trip: the sampled configuration is moved to the effector space by the forward
+// kinematics, solved back by the inverse kinematics and moved forward again. NaNs are kept, the statistics count them.
+struct RoundTripSample {
+	// forward kinematics of the IK solution against the effector pose it was solved for
+	float positionError;
+	float rotationError;	// degrees
+	// largest distance between an IK joint position and the origin of the IK frame it belongs to
+	float jointError;
+	ConfigurationSpace solution;
+	bool singular;
+};
+
+// Random configuration number index of the sequence picked by seed. The same (seed, index) always gives the same
+// configuration, so a run does not depend on the thread count. Angles cover [-pi, pi), q2 [0.5, 6).
+ConfigurationSpace sampleConfiguration(uint64_t seed, uint64_t index);
+
+RoundTripSample roundTrip(const ConfigurationSpace& configSpace, const glm::vec3& lengths);
+
+// roundTrip through the double precision reference kinematics
+RoundTripSample referenceRoundTrip(const ConfigurationSpace& configSpace, const glm::vec3& lengths);
+
+// Largest difference between the joint angles (degrees, taken the shorter way around) of two solutions
+float angleDeviation(const ConfigurationSpace& a, const ConfigurationSpace& b);
+
+// Summary of one error metric over all samples, NaNs are counted and left out of the other values
+struct ErrorDistribution {
+	std::string name;
+	size_t nanCount = 0;
+	double mean = 0.0;
+	float p50 = 0.f;
+	float p90 = 0.f;
+	float p99 = 0.f;
+	float p999 = 0.f;
+	float max = 0.f;
+};
+
+// reorders values
+ErrorDistribution summarizeErrors(const std::string& name, std::vector<float>& values);
@@ -0,0 +1,149 @@
+#include "RoundTrip.h"
+#include "parallel.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Runs FK -> IK -> FK round trips over random configurations on all cores, in float and in the double precision
+// reference, and reports the error distributions, failure and NaN rates and the throughput of both.
+// Exits with 1 when any float round trip fails, 2 on bad arguments.
+static void printUsage()
+{
+	std::cout << "usage: IKRoundTrip [--samples count] [--seed value] [--lengths L1 L3 L4]" << std::endl
+		<< "                  [--tolerance units] [--angle-tolerance degrees]" << std::endl;
+}
+
+struct PassResult {
+	std::vector<float> positionErrors;
+	std::vector<float> rotationErrors;
+	std::vector<float> jointErrors;
+	std::vector<ConfigurationSpace> solutions;
+	std::vector<char> singular;
+	std::vector<char> failed;
+	double elapsed = 0.0;
+};
+
+template <typename RoundTrip>
+static PassResult runPass(size_t sampleCount, uint64_t seed, const glm::vec3& lengths, float positionTolerance,
+	float angleTolerance, RoundTrip roundTrip)
+{
+	PassResult result;
+	result.positionErrors.resize(sampleCount);
+	result.rotationErrors.resize(sampleCount);
+	result.jointErrors.resize(sampleCount);
+	result.solutions.resize(sampleCount);
+	result.singular.resize(sampleCount);
+	result.failed.resize(sampleCount);
+
+	auto start = std::chrono::steady_clock::now();
+	parallelFor(sampleCount, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			RoundTripSample sample = roundTrip(sampleConfiguration(seed, i), lengths);
+			result.positionErrors[i] = sample.positionError;
+			result.rotationErrors[i] = sample.rotationError;
+			result.jointErrors[i] = sample.jointError;
+			result.solutions[i] = sample.solution;
+			result.singular[i] = sample.singular;
+			// written so that NaNs fail
+			result.failed[i] = !(sample.positionError <= positionTolerance) || !(sample.rotationError <= angleTolerance);
+		}
+	}, 4096);
+	result.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+static void printDistribution(const ErrorDistribution& distribution)
+{
+	printf("%-32s %10.3g %10.3g %10.3g %10.3g %10.3g %10.3g %8zu\n", distribution.name.c_str(), distribution.mean,
+		distribution.p50, distribution.p90, distribution.p99, distribution.p999, distribution.max, distribution.nanCount);
+}
+
+static void printPass(const char* name, const PassResult& result)
+{
+	size_t sampleCount = result.failed.size();
+	size_t failures = 0;
+	size_t nans = 0;
+	size_t singular = 0;
+	size_t singularFailures = 0;
+	for (size_t i = 0; i < sampleCount; i++) {
+		bool nan = std::isnan(result.positionErrors[i]) || std::isnan(result.rotationErrors[i]);
+		failures += result.failed[i];
+		nans += nan;
+		singular += result.singular[i];
+		singularFailures += result.singular[i] && result.failed[i];
+	}
+	printf("%-10s %10zu %12.3g%% %8zu %10zu %18zu %12.3g\n", name, failures, 100.0 * failures / sampleCount, nans,
+		singular, singularFailures, result.elapsed > 0.0 ? sampleCount / result.elapsed : 0.0);
+}
+
+int main(int argc, char** argv)
+{
+	size_t sampleCount = 1000000;
+	uint64_t seed = 1;
+	glm::vec3 lengths(3.f, 2.f, 4.f);
+	float positionTolerance = 1e-3f;
+	float angleTolerance = 0.01f;
+
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--samples") == 0 && hasValue)
+			sampleCount = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+			seed = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--lengths") == 0 && i + 3 < argc) {
+			lengths.x = (float)atof(argv[++i]);
+			lengths.y = (float)atof(argv[++i]);
+			lengths.z = (float)atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--tolerance") == 0 && hasValue)
+			positionTolerance = (float)atof(argv[++i]);
+		else if (strcmp(argv[i], "--angle-tolerance") == 0 && hasValue)
+			angleTolerance = (float)atof(argv[++i]);
+		else {
+			printUsage();
+			return 2;
+		}
+	}
+	if (sampleCount == 0 || !(lengths.x > 0.f) || !(lengths.y > 0.f) || !(lengths.z > 0.f)) {
+		printUsage();
+		return 2;
+	}
+
+	PassResult single = runPass(sampleCount, seed, lengths, positionTolerance, angleTolerance, roundTrip);
+	PassResult reference = runPass(sampleCount, seed, lengths, positionTolerance, angleTolerance, referenceRoundTrip);
+
+	// how far rounding moves the float solution from the reference one
+	std::vector<float> angleDeviations(sampleCount);
+	std::vector<float> q2Deviations(sampleCount);
+	for (size_t i = 0; i < sampleCount; i++) {
+		angleDeviations[i] = angleDeviation(single.solutions[i], reference.solutions[i]);
+		q2Deviations[i] = std::abs(single.solutions[i].q2 - reference.solutions[i].q2);
+	}
+
+	printf("%zu random configurations, seed %llu, lengths %g %g %g\n\n", sampleCount, (unsigned long long)seed,
+		lengths.x, lengths.y, lengths.z);
+	printf("%-32s %10s %10s %10s %10s %10s %10s %8s\n", "error", "mean", "p50", "p90", "p99", "p99.9", "max", "NaN");
+	printDistribution(summarizeErrors("position (float)", single.positionErrors));
+	printDistribution(summarizeErrors("position (double)", reference.positionErrors));
+	printDistribution(summarizeErrors("rotation [deg] (float)", single.rotationErrors));
+	printDistribution(summarizeErrors("rotation [deg] (double)", reference.rotationErrors));
+	printDistribution(summarizeErrors("joint vs frame (float)", single.jointErrors));
+	printDistribution(summarizeErrors("joint vs frame (double)", reference.jointErrors));
+	printDistribution(summarizeErrors("float vs double angles [deg]", angleDeviations));
+	printDistribution(summarizeErrors("float vs double q2", q2Deviations));
+
+	printf("\nfailure: position error > %g or rotation error > %g deg or NaN\n", positionTolerance, angleTolerance);
+	printf("%-10s %10s %13s %8s %10s %18s %12s\n", "precision", "failures", "rate", "NaN", "singular",
+		"singular failures", "samples/s");
+	printPass("float", single);
+	printPass("double", reference);
+
+	for (char failed : single.failed) {
+		if (failed)
+			return 1;
+	}
+	return 0;
+}
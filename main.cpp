@@ -10,6 +10,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstring>
 
 #include "glad/glad.h"
 #include "GLFW/glfw3.h"
@@ -22,12 +23,18 @@
 #include "EBO.h"
 #include "Camera.h"
 #include "Grid.h"
-#include "mesh.h"
+#include "GeometryArena.h"
+#include "MeshLoader.h"
 #include "ControlledInputFloat.h"
 #include "ControlledInputInt.h"
 #include "simulator.h"
-#include <thread>
-#include "Frame.h"
+#include "trajectory.h"
+#include "SimulationWorker.h"
+#include <memory>
+#include "Transform.h"
+#include "LinkInstances.h"
+#include "UBO.h"
+#include "FrameUniforms.h"
 
 const float near = 0.1f;
 const float far = 300.0f;
@@ -35,22 +42,48 @@ const int dispCount = 2;
 
 Camera *camera;
 Grid* grid;
-Mesh* cylinder;
-Mesh* sphere;
-Mesh* pointerX;
-Mesh* pointerY;
-Mesh* pointerZ;
+GeometryArena* geometry;
+// robot mesh files and their ids in the arena, indexed by LinkMesh
+const char* linkMeshPaths[linkMeshCount] = {
+    "Meshes\\cylinder.obj",
+    "Meshes\\sphere.obj",
+    "Meshes\\pointerX.obj",
+    "Meshes\\pointerY.obj",
+    "Meshes\\pointerZ.obj"
+};
+std::array<int, linkMeshCount> linkMeshIds;
+// parses the robot meshes in the background, robots are drawn once all of them are in the arena
+MeshLoader* meshLoader;
+bool robotMeshesReady = false;
+LinkInstances* linkInstances;
+std::vector<DrawElementsIndirectCommand> drawCommands;
 
 glm::mat4 view;
 glm::mat4 proj;
+// robot models are Z-up while the scene is Y-up: (x, y, z) -> (x, z, -y)
+const glm::mat4 modelToScene(
+    1.f, 0.f, 0.f, 0.f,
+    0.f, 0.f, -1.f, 0.f,
+    0.f, 1.f, 0.f, 0.f,
+    0.f, 0.f, 0.f, 1.f);
 
 void window_size_callback(GLFWwindow *window, int width, int height);
-void launchCalcThread();
-void phongRenderCalls(std::array<glm::mat4, 5> models, float q2, glm::vec3 lengths);
+void launchSimulation();
+void launchBake();
+void renderTickStats();
+SymParams createSymParams();
+void renderRobots(int firstRobot, int robotCount);
+void setViewportArray();
+void pollMeshes();
+void renderLoadingStatus();
+bool hasExtension(const char* name);
 glm::vec3 changeCoordianteSystem(glm::vec3 vec);
 
-int viewLoc, projLoc, colorLoc;
-int phongModelLoc, phongViewLoc, phongProjLoc, phongColorLoc;
+int colorLoc;
+
+// camera and lighting, shared by every shader through one uniform block
+UBO* frameUbo;
+FrameUniforms frameUniforms;
 
 ControlledInputFloat speed("Speed [%/sec]", 25.f, 0.1f, 0.1f, 100.f);
 glm::vec3 startPos(0.f);
@@ -64,10 +97,26 @@ glm::quat endQ(1.f, 0.f, 0.f, 0.f);
 ControlledInputFloat l1("L1", 3.f, 0.01f, 0.01f);
 ControlledInputFloat l3("L3", 2.f, 0.01f, 0.01f);
 ControlledInputFloat l4("L4", 4.f, 0.01f, 0.01f);
+ControlledInputInt tickRate("Tick rate [Hz]", defaultTickRate, 10, 10, 10000);
+ControlledInputInt spinThreshold("Spin [us]", 500, 50, 0, 10000);
+std::string statsPath = "tick_stats.csv";
+std::string statsStatus;
 
-SymMemory* memory;
+SimulationWorker* worker;
 SymData data;
-std::thread calcThread;
+// two newest simulation snapshots, blended for the present time
+SymData prevData;
+SymData currData;
+
+// both halves drawn in one pass through gl_ViewportIndex, needs GL_ARB_shader_viewport_layer_array
+static bool viewportArraySupported = false;
+static bool singlePassViewports = false;
+
+static bool bakeMode = false;
+static bool loopPlayback = false;
+std::shared_ptr<const BakedTrajectory> baked;
+TrajectoryCache trajectoryCache;
+float playbackTime = 0.f;
 
 int main() { 
     // initial values
@@ -94,23 +143,33 @@ int main() {
     gladLoadGL();
     glEnable(GL_DEPTH_TEST);
 
+    GLint maxViewports = 0;
+    glGetIntegerv(GL_MAX_VIEWPORTS, &maxViewports);
+    viewportArraySupported = hasExtension("GL_ARB_shader_viewport_layer_array") && maxViewports >= dispCount;
+    singlePassViewports = viewportArraySupported;
+
     GLFWimage icon;
     icon.pixels = stbi_load("icon.png", &icon.width, &icon.height, 0, 4);
     glfwSetWindowIcon(window, 1, &icon);
     stbi_image_free(icon.pixels);
     #pragma endregion
 
+    // meshes parse while the shaders compile and the first frames are shown
+    meshLoader = new MeshLoader(std::vector<std::string>(std::begin(linkMeshPaths), std::end(linkMeshPaths)));
+
     // shaders and uniforms
     Shader shaderProgram("Shaders\\default.vert", "Shaders\\default.frag");
-    viewLoc = glGetUniformLocation(shaderProgram.ID, "view");
-    projLoc = glGetUniformLocation(shaderProgram.ID, "proj");
     colorLoc = glGetUniformLocation(shaderProgram.ID, "color");
 
     Shader phongShader("Shaders\\phong.vert", "Shaders\\phong.frag");
-	phongModelLoc = glGetUniformLocation(phongShader.ID, "model");
-    phongViewLoc = glGetUniformLocation(phongShader.ID, "view");
-    phongProjLoc = glGetUniformLocation(phongShader.ID, "proj");
-    phongColorLoc = glGetUniformLocation(phongShader.ID, "objectColor");
+
+    frameUbo = new UBO(sizeof(FrameUniforms), frameUniformsBinding);
+    // (300, 300, 300) of the scene
+    frameUniforms.lightPos = glm::vec4(300.f, -300.f, 300.f, 1.f);
+    frameUniforms.lightColor = glm::vec4(1.f, 1.f, 1.f, 1.f);
+    frameUniforms.ambientStrength = 0.01f;
+    frameUniforms.specularStrength = 0.5f;
+    frameUniforms.shininess = 2.f;
 
     // callbacks
     glfwSetWindowSizeCallback(window, window_size_callback);
@@ -119,11 +178,14 @@ int main() {
     camera->PrepareMatrices(view, proj);
 
     grid = new Grid();
-	cylinder = new Mesh("Meshes\\cylinder.obj", glm::vec4(1.0f, 1.0f, 0.0f, 1.0f));
-	sphere = new Mesh("Meshes\\sphere.obj", glm::vec4(0.0f, 1.0f, 1.0f, 1.0f));
-	pointerX = new Mesh("Meshes\\pointerX.obj", glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
-	pointerY = new Mesh("Meshes\\pointerY.obj", glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
-	pointerZ = new Mesh("Meshes\\pointerZ.obj", glm::vec4(0.0f, 1.0f, 0.0f, 1.0f));
+	geometry = new GeometryArena();
+	linkInstances = new LinkInstances({
+		glm::vec4(1.0f, 1.0f, 0.0f, 1.0f),
+		glm::vec4(0.0f, 1.0f, 1.0f, 1.0f),
+		glm::vec4(1.0f, 0.0f, 0.0f, 1.0f),
+		glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+		glm::vec4(0.0f, 1.0f, 0.0f, 1.0f)
+	});
 
     #pragma region imgui_boilerplate
     IMGUI_CHECKVERSION();
@@ -136,7 +198,10 @@ int main() {
     #pragma endregion
 
 	// simulation
-    launchCalcThread();
+    worker = new SimulationWorker();
+    worker->SetTickRate((int)tickRate.GetValue());
+    worker->SetSpinThreshold((int)spinThreshold.GetValue());
+    launchSimulation();
 
     while (!glfwWindowShouldClose(window)) 
     {
@@ -154,43 +219,77 @@ int main() {
         camera->HandleInputs(window);
         camera->PrepareMatrices(view, proj);
 
-		memory->mutex.lock();
-		data = memory->data;
-		memory->mutex.unlock();
+        if (!meshLoader->IsDone())
+            pollMeshes();
+
+        if (baked) {
+            playbackTime += io.DeltaTime;
+            if (playbackTime > baked->GetDuration())
+                playbackTime = loopPlayback ? std::fmod(playbackTime, baked->GetDuration()) : baked->GetDuration();
+            baked->Sample(playbackTime, data);
+        }
+        else {
+            if (worker->Update()) {
+                prevData = currData;
+                currData = worker->GetData();
+            }
+            interpolateSymData(prevData, currData, std::chrono::steady_clock::now(), data);
+        }
         
+        frameUniforms.view = view;
+        frameUniforms.proj = proj;
+        frameUniforms.phongView = view * modelToScene;
+        frameUniforms.viewPos = glm::inverse(modelToScene) * glm::vec4(camera->Position, 1.f);
+        frameUbo->Write(&frameUniforms);
+
         // render non-grayscaleable objects
         shaderProgram.Activate();
 
-        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(proj));
-
-        // render left side
-        glViewport(0, 0, camera->GetWidth(), camera->GetHeight());
-        grid->Render(colorLoc);
-
-        // render right side
-        glViewport(camera->GetWidth(), 0, camera->GetWidth(), camera->GetHeight());
-        grid->Render(colorLoc);
-
-		// render shaded objects
-		phongShader.Activate();
-
-		glUniformMatrix4fv(phongViewLoc, 1, GL_FALSE, glm::value_ptr(view));
-		glUniformMatrix4fv(phongProjLoc, 1, GL_FALSE, glm::value_ptr(proj));
-
-		// render left side
-        glViewport(0, 0, camera->GetWidth(), camera->GetHeight());
-		phongRenderCalls(data.leftModels, data.q2s.at(0), data.lengths);
+        if (singlePassViewports) {
+            setViewportArray();
+            grid->RenderInstanced(colorLoc, dispCount);
+        }
+        else {
+            // render left side
+            glViewport(0, 0, camera->GetWidth(), camera->GetHeight());
+            grid->Render(colorLoc);
+
+            // render right side
+            glViewport(camera->GetWidth(), 0, camera->GetWidth(), camera->GetHeight());
+            grid->Render(colorLoc);
+        }
 
-		// render right side
-        glViewport(camera->GetWidth(), 0, camera->GetWidth(), camera->GetHeight());
-		phongRenderCalls(data.rightModels, data.q2s.at(1), data.lengths);
+		if (robotMeshesReady) {
+			// render shaded objects, all link transforms of the frame go to the GPU in one upload
+			linkInstances->Clear();
+			int leftRobot = linkInstances->Add(data.leftModels, data.q2s.at(0), data.lengths, 0);
+			int rightRobot = linkInstances->Add(data.rightModels, data.q2s.at(1), data.lengths, 1);
+			linkInstances->Upload(0, 1);
+
+			phongShader.Activate();
+
+			if (singlePassViewports) {
+				// viewport array is still set from the grid pass
+				renderRobots(0, linkInstances->GetRobotCount());
+			}
+			else {
+				// render left side
+				glViewport(0, 0, camera->GetWidth(), camera->GetHeight());
+				renderRobots(leftRobot, 1);
+
+				// render right side
+				glViewport(camera->GetWidth(), 0, camera->GetWidth(), camera->GetHeight());
+				renderRobots(rightRobot, 1);
+			}
+		}
 
         // imgui rendering
         ImGui::Begin("Menu", 0,
             ImGuiWindowFlags_NoMove |
             ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
 
+        renderLoadingStatus();
+
         ImGui::SeparatorText("Position:");
 		ImGui::InputFloat("X_start",    &startPos.x,   0.01f, 0.1f, "%.2f");
 		ImGui::InputFloat("Y_start",    &startPos.y,   0.01f, 0.1f, "%.2f");
@@ -232,37 +331,70 @@ int main() {
         ImGui::Spacing();
 
 		ImGui::SeparatorText("Lengths:");
-		l1.Render();
-		l3.Render();
-		l4.Render();
+		// bitwise or so every input is drawn
+		if ((l1.Render() | l3.Render() | l4.Render()) && !baked)
+			worker->SetLengths(glm::vec3(l1.GetValue(), l3.GetValue(), l4.GetValue()));
         ImGui::Spacing();
 
         ImGui::SeparatorText("Options:");
-        speed.Render();
+        if (speed.Render() && !baked)
+            worker->SetSpeed(speed.GetValue());
+        if (tickRate.Render())
+            worker->SetTickRate((int)tickRate.GetValue());
+        if (spinThreshold.Render())
+            worker->SetSpinThreshold((int)spinThreshold.GetValue());
+        ImGui::BeginDisabled(!viewportArraySupported);
+        ImGui::Checkbox("Single-pass viewports", &singlePassViewports);
+        ImGui::EndDisabled();
+        ImGui::Checkbox("Bake trajectory", &bakeMode);
+        if (baked) {
+            ImGui::SameLine();
+            ImGui::Checkbox("Loop", &loopPlayback);
+            ImGui::SliderFloat("Time [s]", &playbackTime, 0.f, baked->GetDuration(), "%.2f");
+            ImGui::Text("Cached: %zu (%.1f MB)", trajectoryCache.GetEntryCount(), trajectoryCache.GetByteSize() / (1024.f * 1024.f));
+        }
+        else {
+            float simTime = data.time;
+            if (ImGui::SliderFloat("Time [s]", &simTime, 0.f, 100.f / speed.GetValue(), "%.2f"))
+                worker->Seek(simTime);
+            if (ImGui::Button(worker->IsPaused() ? "Resume" : "Pause")) {
+                if (worker->IsPaused())
+                    worker->Resume();
+                else
+                    worker->Pause();
+            }
+        }
 
         ImGui::Spacing();
         if (ImGui::Button("Run", ImVec2(ImGui::GetContentRegionAvail().x, 0))) {
-			memory->mutex.lock();
-			memory->terminateThread = true;
-			memory->mutex.unlock();
-			calcThread.join();
-
-			launchCalcThread();
+			if (bakeMode) {
+				worker->Stop();
+				launchBake();
+			}
+			else
+				launchSimulation();
         }
 
+        ImGui::Spacing();
+        renderTickStats();
+
         ImGui::End();
         #pragma region rest
         ImGui::Render();
         //std::cout << ImGui::GetIO().Framerate << std::endl;
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
+        frameUbo->Fence();
         glfwSwapBuffers(window);
         glfwPollEvents();
         #pragma endregion
     }
     #pragma region exit
-	memory->terminateThread = true;
-    calcThread.join();
+    delete worker;
+    delete meshLoader;
+    linkInstances->Delete();
+    geometry->Delete();
+    frameUbo->Delete();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -280,7 +412,96 @@ void window_size_callback(GLFWwindow *window, int width, int height) {
   camera->PrepareMatrices(view, proj);
 }
 
-void launchCalcThread()
+void pollMeshes()
+{
+	meshLoader->Poll([](size_t mesh, const MeshData& meshData, const ParseStats& stats) {
+		linkMeshIds[mesh] = geometry->Add(meshData);
+		std::cout << linkMeshPaths[mesh] << (stats.cached ? " (cached)" : "") << ": " << stats.cornerCount << " -> "
+			<< stats.vertexCount << " vertices, ACMR " << stats.acmrBefore << " -> " << stats.acmrAfter << std::endl;
+	});
+
+	if (meshLoader->IsDone()) {
+		for (size_t mesh = 0; mesh < meshLoader->GetCount(); mesh++) {
+			if (!meshLoader->GetError(mesh).empty())
+				std::cout << meshLoader->GetPath(mesh) << ": " << meshLoader->GetError(mesh) << std::endl;
+		}
+		robotMeshesReady = !meshLoader->HasFailed();
+	}
+}
+
+void renderLoadingStatus()
+{
+	if (!meshLoader->IsDone()) {
+		char overlay[32];
+		snprintf(overlay, sizeof(overlay), "Loading meshes %zu/%zu", meshLoader->GetCollectedCount(), meshLoader->GetCount());
+		ImGui::ProgressBar((float)meshLoader->GetCollectedCount() / meshLoader->GetCount(), ImVec2(-1.f, 0.f), overlay);
+		ImGui::Spacing();
+	}
+	else if (meshLoader->HasFailed()) {
+		for (size_t mesh = 0; mesh < meshLoader->GetCount(); mesh++) {
+			if (!meshLoader->GetError(mesh).empty())
+				ImGui::TextColored(ImVec4(1.f, 0.3f, 0.3f, 1.f), "%s: %s", meshLoader->GetPath(mesh).c_str(), meshLoader->GetError(mesh).c_str());
+		}
+		ImGui::Spacing();
+	}
+}
+
+void launchSimulation()
+{
+    baked.reset();
+    worker->Start(createSymParams());
+}
+
+void launchBake()
+{
+    // playback blends samples, so baking does not have to follow the live tick rate
+    baked = trajectoryCache.GetOrBake(createSymParams(), 1.f / defaultTickRate);
+    playbackTime = 0.f;
+}
+
+void renderTickStats()
+{
+    if (!ImGui::CollapsingHeader("Tick stats"))
+        return;
+
+    const TickStats& stats = worker->GetTickStats();
+    const char* names[] = { "compute", "overshoot", "debt" };
+    const Histogram* histograms[] = { &stats.compute, &stats.overshoot, &stats.sleepDebt };
+    const double percentiles[] = { 50.0, 99.0, 99.9 };
+
+    ImGui::Text("Ticks: %llu", (unsigned long long)stats.compute.GetTotalCount());
+    if (ImGui::BeginTable("tickStats", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame)) {
+        ImGui::TableSetupColumn("[us]");
+        ImGui::TableSetupColumn("p50");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("p99.9");
+        ImGui::TableSetupColumn("max");
+        ImGui::TableHeadersRow();
+        for (int i = 0; i < 3; i++) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(names[i]);
+            for (double percentile : percentiles) {
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", histograms[i]->GetValueAtPercentile(percentile) / 1000.0);
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", histograms[i]->GetMax() / 1000.0);
+        }
+        ImGui::EndTable();
+    }
+
+    if (ImGui::Button("Reset"))
+        worker->ResetStats();
+    ImGui::SameLine();
+    if (ImGui::Button("Dump CSV"))
+        statsStatus = stats.WriteCsv(statsPath) ? "Saved " + statsPath : "Failed to write " + statsPath;
+    ImGui::InputText("File", &statsPath);
+    if (!statsStatus.empty())
+        ImGui::TextUnformatted(statsStatus.c_str());
+}
+
+SymParams createSymParams()
 {
     glm::quat startQuat;
 	glm::quat endQuat;
@@ -294,34 +515,40 @@ void launchCalcThread()
         endQuat = glm::normalize(endQ);
     }
 
-    memory = new SymMemory(
-        Frame(changeCoordianteSystem(startPos), startQuat),
-        Frame(changeCoordianteSystem(endPos), endQuat),
+    return SymParams(
+        Transform(changeCoordianteSystem(startPos), startQuat),
+        Transform(changeCoordianteSystem(endPos), endQuat),
         speed.GetValue(), glm::vec3(l1.GetValue(), l3.GetValue(), l4.GetValue()));
-    data = memory->data;
-    calcThread = std::thread(calculationThread, memory);
 }
 
-void phongRenderCalls(std::array<glm::mat4,5> models, float q2, glm::vec3 lengths)
+// one indirect command per mesh, however many robots are in the range
+void renderRobots(int firstRobot, int robotCount)
 {
-    glUniformMatrix4fv(phongModelLoc, 1, GL_FALSE, glm::value_ptr(models.at(0) * glm::scale(glm::mat4(1.f), glm::vec3(1.f, 1.f, lengths.x))));
-    cylinder->Render(phongColorLoc);
-    glUniformMatrix4fv(phongModelLoc, 1, GL_FALSE, glm::value_ptr(models.at(1) * glm::scale(glm::mat4(1.f), glm::vec3(1.f, 1.f, q2))));
-    cylinder->Render(phongColorLoc);
-    glUniformMatrix4fv(phongModelLoc, 1, GL_FALSE, glm::value_ptr(models.at(2) * glm::scale(glm::mat4(1.f), glm::vec3(1.f, 1.f, lengths.y))));
-    cylinder->Render(phongColorLoc);
-    glUniformMatrix4fv(phongModelLoc, 1, GL_FALSE, glm::value_ptr(models.at(3) * glm::scale(glm::mat4(1.f), glm::vec3(1.f, 1.f, lengths.z))));
-    cylinder->Render(phongColorLoc);
-
-    for (auto& model : models) {
-        glUniformMatrix4fv(phongModelLoc, 1, GL_FALSE, glm::value_ptr(model));
-        if (model == models.back()) continue;
-        sphere->Render(phongColorLoc);
+    drawCommands.clear();
+    for (int mesh = 0; mesh < linkMeshCount; mesh++) {
+        drawCommands.push_back(geometry->GetCommand(linkMeshIds[mesh],
+            LinkInstances::GetInstanceCount((LinkMesh)mesh, robotCount),
+            linkInstances->GetBaseInstance((LinkMesh)mesh, firstRobot)));
     }
+    geometry->Draw(drawCommands);
+}
 
-    pointerX->Render(phongColorLoc);
-    pointerY->Render(phongColorLoc);
-    pointerZ->Render(phongColorLoc);
+// viewport i covers the i-th display, gl_ViewportIndex picks it per primitive
+void setViewportArray()
+{
+    for (int i = 0; i < dispCount; i++)
+        glViewportIndexedf(i, camera->GetWidth() * i, 0.f, camera->GetWidth(), camera->GetHeight());
+}
+
+bool hasExtension(const char* name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++) {
+        if (strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), name) == 0)
+            return true;
+    }
+    return false;
 }
 
 glm::vec3 changeCoordianteSystem(glm::vec3 vec)